@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Generates vitis/breakout/src/dynclk/dynclk_table.h, the precomputed axi_dynclk
+PLL settings for every pixel clock in display_ctrl/vga_modes.h.
+
+The search and register packing mirror ClkFindParams and ClkFindReg in
+dynclk/dynclk.c step for step (same loop order, same double arithmetic and
+rounding), and the lock/filter words come from the lookup tables in
+dynclk/dynclk.h, so the table matches what the board would compute.
+Rerun it whenever a mode is added or its frequency changes.
+
+usage: gen_dynclk_table.py [--src vitis/breakout/src] [--check]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+CLK_BIT_WEDGE = 13
+ERR = None
+
+
+def parse_modes(path):
+    text = open(path).read()
+    modes = []
+    for name, body in re.findall(r"static const VideoMode (\w+) = \{(.*?)\};", text, re.S):
+        freq = re.search(r"\.freq\s*=\s*([0-9.]+)", body).group(1)
+        modes.append((name, freq))
+    return modes
+
+
+def parse_table(text, name):
+    body = re.search(r"%s\[64\] = \{(.*?)\};" % name, text, re.S).group(1)
+    return [int(v, 2) for v in re.findall(r"0b([01]+)", body)]
+
+
+def clk_divider(divide):
+    if divide < 1 or divide > 128:
+        return ERR
+    if divide == 1:
+        return 0x1041
+    high = divide // 2
+    output = 0
+    if divide & 1:
+        low = high + 1
+        output = 1 << CLK_BIT_WEDGE
+    else:
+        low = high
+    output |= 0x03F & low
+    output |= 0xFC0 & (high << 6)
+    return output
+
+
+def clk_count_calc(divide):
+    div = clk_divider(divide)
+    if div is ERR:
+        return ERR
+    return (0xFFF & div) | ((div << 10) & 0x00C00000)
+
+
+def find_params(freq):
+    best_error = 2000.0
+    freq = freq * 5.0
+    best = None
+    for cur_div in range(1, 11):
+        min_fb = cur_div * 6
+        max_fb = min(cur_div * 12, 64)
+        clk_mult = (100.0 / float(cur_div)) / freq
+        for cur_fb in range(min_fb, max_fb + 1):
+            # (u32)(x + 0.5) truncates toward zero like int()
+            clk_div = int(clk_mult * float(cur_fb) + 0.5)
+            cur_freq = ((100.0 / float(cur_div)) / float(clk_div)) * float(cur_fb)
+            error = abs(cur_freq - freq)
+            if error < best_error:
+                best_error = error
+                best = (cur_freq, cur_fb, clk_div, cur_div)
+    cur_freq, fbmult, clkdiv, maindiv = best
+    return cur_freq / 5.0, fbmult, clkdiv, maindiv
+
+
+def find_reg(fbmult, clkdiv, maindiv, lock_lookup, filter_lookup_low):
+    if fbmult < 2 or fbmult > 64:
+        return None
+    clk0L = clk_count_calc(clkdiv)
+    clkFBL = clk_count_calc(fbmult)
+    divclk = clk_divider(maindiv)
+    if ERR in (clk0L, clkFBL, divclk):
+        return None
+    lock = lock_lookup[fbmult - 1]
+    lockL = lock & 0xFFFFFFFF
+    fltr_lockH = (lock >> 32) & 0xFF
+    fltr_lockH |= (filter_lookup_low[fbmult - 1] << 16) & 0x03FF0000
+    return clk0L, clkFBL, 0, divclk, lockL, fltr_lockH
+
+
+def generate(src):
+    modes = parse_modes(os.path.join(src, "display_ctrl", "vga_modes.h"))
+    dynclk_h = open(os.path.join(src, "dynclk", "dynclk.h")).read()
+    lock_lookup = parse_table(dynclk_h, "lock_lookup")
+    filter_lookup_low = parse_table(dynclk_h, "filter_lookup_low")
+
+    lines = [
+        "/*",
+        " * Generated by tools/gen_dynclk_table.py from display_ctrl/vga_modes.h, do not edit.",
+        " * PLL parameters and register values that ClkFindParams and ClkFindReg",
+        " * produce for each video mode's pixel clock, see ClkLookup.",
+        " */",
+        "",
+        "#ifndef DYNCLK_TABLE_H_",
+        "#define DYNCLK_TABLE_H_",
+        "",
+        '#include "dynclk.h"',
+        "",
+        "typedef struct {",
+        "\t\tdouble freq; /* Requested pixel clock, as written in vga_modes.h */",
+        "\t\tClkMode mode;",
+        "\t\tClkConfig config;",
+        "} ClkTableEntry;",
+        "",
+        "static const ClkTableEntry clk_table[] = {",
+    ]
+    seen = set()
+    for name, freq in modes:
+        if freq in seen:
+            continue
+        seen.add(freq)
+        actual, fbmult, clkdiv, maindiv = find_params(float(freq))
+        regs = find_reg(fbmult, clkdiv, maindiv, lock_lookup, filter_lookup_low)
+        if regs is None:
+            raise ValueError("%s: no register values for %s MHz" % (name, freq))
+        lines.append("\t{ /* %s */" % name)
+        lines.append("\t\t.freq = %s," % freq)
+        lines.append("\t\t.mode = { .freq = %r, .fbmult = %d, .clkdiv = %d, .maindiv = %d },"
+                     % (actual, fbmult, clkdiv, maindiv))
+        lines.append("\t\t.config = { 0x%08X, 0x%08X, 0x%08X, 0x%08X, 0x%08X, 0x%08X }" % regs)
+        lines.append("\t},")
+    lines += ["};", "", "#endif /* DYNCLK_TABLE_H_ */", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    default_src = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                               "..", "vitis", "breakout", "src")
+    parser.add_argument("--src", default=default_src, help="application source directory")
+    parser.add_argument("--check", action="store_true",
+                        help="only report whether the table is up to date")
+    args = parser.parse_args()
+
+    table = generate(args.src)
+    path = os.path.join(args.src, "dynclk", "dynclk_table.h")
+    if args.check:
+        current = open(path).read() if os.path.exists(path) else ""
+        if current != table:
+            print("%s is out of date" % path, file=sys.stderr)
+            sys.exit(1)
+        return
+    with open(path, "w") as f:
+        f.write(table)
+    print("wrote %s" % os.path.normpath(path))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Reports where the sections and symbols of the application ELF landed in the
+memory regions of the linker script (vitis/breakout/src/lscript.ld): every
+allocated section with its run (VMA) and load (LMA) address and region, the
+functions and objects placed in OCM (see placement.h), and how full each
+region is.
+
+usage: placement_report.py breakout.elf [--lscript lscript.ld]
+                           [--objdump arm-none-eabi-objdump] [--nm arm-none-eabi-nm]
+"""
+
+import argparse
+import os
+import re
+import subprocess
+
+DEFAULT_LSCRIPT = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                               "..", "vitis", "breakout", "src", "lscript.ld")
+MEMORY_LINE = re.compile(r"^\s*(\w+)\s*:\s*ORIGIN\s*=\s*(0x[0-9a-fA-F]+|\d+)\s*,"
+                         r"\s*LENGTH\s*=\s*(0x[0-9a-fA-F]+|\d+)")
+
+
+def load_regions(lscript):
+    regions = []
+    in_memory = False
+    with open(lscript) as f:
+        for line in f:
+            if line.strip().startswith("MEMORY"):
+                in_memory = True
+            elif in_memory and line.strip().startswith("}"):
+                break
+            elif in_memory:
+                match = MEMORY_LINE.match(line)
+                if match:
+                    regions.append((match.group(1), int(match.group(2), 0), int(match.group(3), 0)))
+    if not regions:
+        raise ValueError("no MEMORY regions found in %s" % lscript)
+    return regions
+
+
+def region_of(regions, address):
+    for name, origin, length in regions:
+        if origin <= address < origin + length:
+            return name
+    return "-"
+
+
+def load_sections(elf, objdump):
+    output = subprocess.run([objdump, "-h", "-w", elf], check=True,
+                            capture_output=True, text=True).stdout
+    sections = []
+    for line in output.splitlines():
+        # Idx Name Size VMA LMA File-off Algn Flags
+        fields = line.split()
+        if len(fields) < 7 or not fields[0].isdigit():
+            continue
+        flags = " ".join(fields[7:])
+        if "ALLOC" not in flags:
+            continue
+        sections.append({"name": fields[1], "size": int(fields[2], 16),
+                         "vma": int(fields[3], 16), "lma": int(fields[4], 16),
+                         "load": "LOAD" in flags})
+    return sections
+
+
+def load_symbols(elf, nm):
+    output = subprocess.run([nm, "-n", "-S", "--defined-only", elf], check=True,
+                            capture_output=True, text=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) != 4 or fields[2] not in "tTdDbBrR":
+            continue
+        symbols.append((int(fields[0], 16), int(fields[1], 16), fields[2], fields[3]))
+    return symbols
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="application ELF")
+    parser.add_argument("--lscript", default=DEFAULT_LSCRIPT, help="linker script with the MEMORY regions")
+    parser.add_argument("--objdump", default="arm-none-eabi-objdump", help="objdump for the target")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="nm for the target")
+    args = parser.parse_args()
+
+    regions = load_regions(args.lscript)
+    sections = load_sections(args.elf, args.objdump)
+    symbols = load_symbols(args.elf, args.nm)
+
+    print("%-20s %10s %10s %8s  %s" % ("section", "vma", "lma", "size", "region"))
+    used = {}
+    for section in sections:
+        if section["size"] == 0:
+            continue
+        region = region_of(regions, section["vma"])
+        load_region = region_of(regions, section["lma"])
+        if section["load"] and load_region != region:
+            region += " (loaded from %s)" % load_region
+            used[load_region] = used.get(load_region, 0) + section["size"]
+        used[region.split()[0]] = used.get(region.split()[0], 0) + section["size"]
+        print("%-20s 0x%08x 0x%08x %8d  %s" % (section["name"], section["vma"], section["lma"],
+                                               section["size"], region))
+
+    ocm = [name for name, _, _ in regions if name.startswith("ps7_ram")]
+    print("\nsymbols in OCM:")
+    print("%10s %8s  %-10s %s" % ("address", "size", "region", "symbol"))
+    for address, size, kind, name in symbols:
+        region = region_of(regions, address)
+        if region in ocm and size > 0:
+            print("0x%08x %8d  %-10s %s" % (address, size, region, name))
+
+    print("\nregions:")
+    for name, origin, length in regions:
+        total = used.get(name, 0)
+        print("%-20s 0x%08x %10d of %10d bytes %5.1f%%" % (name, origin, total, length,
+                                                           100.0 * total / length))
+        if total > length:
+            print("warning: %s overflows by %d bytes" % (name, total - length))
+
+
+if __name__ == "__main__":
+    main()
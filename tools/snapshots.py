@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+Lists the GameState snapshots dumped by snapshot_ring_dump_uart()
+(vitis/breakout/src/snapshot.c) and extracts single images that
+snapshot_load_uart() can load to start a run from that frame.
+
+The input can be a raw capture of the UART session: text printed around the
+dump is skipped by searching for the "BRKG" magic.
+
+usage: snapshots.py capture.bin                    list the frames
+       snapshots.py capture.bin -f 1234 -o s.bin   extract frame 1234
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"BRKG"
+VERSION = 1
+FLAG_FIXED_POINT = 0x01
+BRICKS = 40
+
+# snapshot_s, little endian, as laid out by arm-none-eabi-gcc
+LAYOUT = struct.Struct("<HBBI6IQi4B")
+
+
+def parse(data):
+    start = data.find(MAGIC)
+    if start < 0:
+        raise ValueError("no snapshots found (missing BRKG magic)")
+    pos = start + len(MAGIC)
+    (count,) = struct.unpack_from("<I", data, pos)
+    pos += 4
+
+    images = []
+    for _ in range(count):
+        if pos + LAYOUT.size > len(data):
+            print("warning: capture ends after %d of %d images" % (len(images), count),
+                  file=sys.stderr)
+            break
+        raw = data[pos:pos + LAYOUT.size]
+        version, flags, size = struct.unpack_from("<HBB", raw)
+        if version != VERSION or size != LAYOUT.size:
+            raise ValueError("unsupported snapshot version %d size %d" % (version, size))
+        images.append(raw)
+        pos += LAYOUT.size
+    return images
+
+
+def scalar(bits, flags):
+    if flags & FLAG_FIXED_POINT:
+        value = bits - (1 << 32) if bits & 0x80000000 else bits
+        return value / 65536.0
+    return struct.unpack("<f", struct.pack("<I", bits))[0]
+
+
+def describe(raw):
+    (version, flags, _, frame, bx, by, bvx, bvy, px, pvx, alive,
+     score, lives, bricks, running, launched) = LAYOUT.unpack(raw)
+    return ("frame %7d  ball %7.1f,%7.1f v %5.1f,%5.1f  paddle %7.1f v %4.1f  "
+            "score %4d lives %d bricks %2d/%d%s%s" % (
+                frame, scalar(bx, flags), scalar(by, flags), scalar(bvx, flags),
+                scalar(bvy, flags), scalar(px, flags), scalar(pvx, flags),
+                score, lives, bricks, bin(alive).count("1"),
+                "" if launched else "  on paddle", "" if running else "  over"))
+
+
+def frame_of(raw):
+    return struct.unpack_from("<I", raw, 4)[0]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="binary UART capture containing a snapshot dump")
+    parser.add_argument("-f", "--frame", type=int, help="frame to extract")
+    parser.add_argument("-o", "--output", help="file to write the extracted snapshot to")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as f:
+        images = parse(f.read())
+
+    if args.frame is None:
+        for raw in images:
+            print(describe(raw))
+        print("%d snapshots" % len(images), file=sys.stderr)
+        return
+
+    matches = [raw for raw in images if frame_of(raw) == args.frame]
+    if not matches:
+        sys.exit("frame %d is not in the capture" % args.frame)
+    if not args.output:
+        sys.exit("--output is needed to extract a frame")
+    with open(args.output, "wb") as f:
+        f.write(MAGIC + struct.pack("<I", 1) + matches[-1])
+    print(describe(matches[-1]), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
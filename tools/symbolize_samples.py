@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+Symbolizes a PC sample histogram dumped by sampler_dump_uart()
+(vitis/breakout/src/sampler.c) against the application ELF and prints the
+functions with the most samples.
+
+The input can be a raw capture of the UART session: text printed around the
+dump is skipped by searching for the "BRKS" magic. Symbols come from nm, so
+the ELF must be the one that produced the capture.
+
+usage: symbolize_samples.py capture.bin breakout.elf [-n 30] [--nm arm-none-eabi-nm]
+"""
+
+import argparse
+import bisect
+import struct
+import subprocess
+import sys
+
+MAGIC = b"BRKS"
+VERSION = 1
+
+
+def parse(data):
+    start = data.find(MAGIC)
+    if start < 0:
+        raise ValueError("no samples found (missing BRKS magic)")
+    pos = start + len(MAGIC)
+
+    version, hz, text_start, bucket_bytes, total, outside, used = \
+        struct.unpack_from("<7I", data, pos)
+    pos += 28
+    if version != VERSION:
+        raise ValueError("unsupported sample dump version %d" % version)
+
+    buckets = []
+    for _ in range(used):
+        if pos + 8 > len(data):
+            print("warning: capture ends after %d of %d buckets" % (len(buckets), used),
+                  file=sys.stderr)
+            break
+        buckets.append(struct.unpack_from("<II", data, pos))
+        pos += 8
+
+    return {"hz": hz, "text_start": text_start, "bucket_bytes": bucket_bytes,
+            "total": total, "outside": outside, "buckets": buckets}
+
+
+def load_symbols(elf, nm):
+    output = subprocess.run([nm, "-n", "--defined-only", elf], check=True,
+                            capture_output=True, text=True).stdout
+    addresses = []
+    names = []
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) != 3 or fields[1] not in "tTwW":
+            continue
+        # ARM mapping symbols ($a, $d, $t) mark code/data, not functions
+        if fields[2].startswith("$"):
+            continue
+        addresses.append(int(fields[0], 16))
+        names.append(fields[2])
+    return addresses, names
+
+
+def symbolize(dump, addresses, names):
+    per_function = {}
+    for address, count in dump["buckets"]:
+        # A bucket that straddles two functions is charged to the one at its start
+        i = bisect.bisect_right(addresses, address) - 1
+        name = names[i] if i >= 0 else "0x%08x" % address
+        per_function[name] = per_function.get(name, 0) + count
+    return sorted(per_function.items(), key=lambda item: item[1], reverse=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="binary UART capture containing a sample dump")
+    parser.add_argument("elf", help="application ELF the samples were taken from")
+    parser.add_argument("-n", "--top", type=int, default=30, help="functions to print")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="nm for the target")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as f:
+        dump = parse(f.read())
+    addresses, names = load_symbols(args.elf, args.nm)
+    functions = symbolize(dump, addresses, names)
+
+    total = dump["total"]
+    print("%d samples at %d Hz (%.1f s), %d outside .text, %d byte buckets"
+          % (total, dump["hz"], total / float(dump["hz"] or 1), dump["outside"],
+             dump["bucket_bytes"]))
+    print("%8s %6s  %s" % ("samples", "%", "function"))
+    for name, count in functions[:args.top]:
+        print("%8d %5.1f%%  %s" % (count, 100.0 * count / max(total, 1), name))
+
+
+if __name__ == "__main__":
+    main()
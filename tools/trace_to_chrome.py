@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Converts a binary trace dumped by trace_dump_uart() (vitis/breakout/src/trace.c)
+into Chrome trace event JSON that chrome://tracing and ui.perfetto.dev can open.
+
+The input can be a raw capture of the UART session: text printed around the
+dump is skipped by searching for the "BRKT" magic.
+
+usage: trace_to_chrome.py capture.bin [-o trace.json]
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b"BRKT"
+VERSION = 1
+PHASES = {0: "B", 1: "E", 2: "i"}
+
+
+def parse(data):
+    start = data.find(MAGIC)
+    if start < 0:
+        raise ValueError("no trace found (missing BRKT magic)")
+    pos = start + len(MAGIC)
+
+    version, counts_per_second, name_count = struct.unpack_from("<III", data, pos)
+    pos += 12
+    if version != VERSION:
+        raise ValueError("unsupported trace version %d" % version)
+
+    names = []
+    for _ in range(name_count):
+        length = data[pos]
+        names.append(data[pos + 1:pos + 1 + length].decode("ascii", "replace"))
+        pos += 1 + length
+
+    (event_count,) = struct.unpack_from("<I", data, pos)
+    pos += 4
+
+    events = []
+    for _ in range(event_count):
+        if pos + 16 > len(data):
+            print("warning: capture ends after %d of %d events" % (len(events), event_count),
+                  file=sys.stderr)
+            break
+        timestamp, name_id, kind, _, arg = struct.unpack_from("<QHBBI", data, pos)
+        pos += 16
+        events.append((timestamp, name_id, kind, arg))
+
+    return counts_per_second, names, events
+
+
+def to_chrome(counts_per_second, names, events):
+    if not events:
+        return {"traceEvents": []}
+
+    origin = events[0][0]
+    open_zones = {}
+    out = []
+    for timestamp, name_id, kind, arg in events:
+        name = names[name_id] if name_id < len(names) else "id%d" % name_id
+        phase = PHASES.get(kind)
+        if phase is None:
+            continue
+
+        # The ring may have dropped the begin of the oldest zones
+        if phase == "E":
+            if open_zones.get(name, 0) == 0:
+                continue
+            open_zones[name] -= 1
+        elif phase == "B":
+            open_zones[name] = open_zones.get(name, 0) + 1
+
+        event = {
+            "name": name,
+            "ph": phase,
+            "ts": (timestamp - origin) * 1e6 / counts_per_second,
+            "pid": 1,
+            "tid": 1,
+        }
+        if phase == "i":
+            event["s"] = "t"
+            event["args"] = {"arg": arg}
+        out.append(event)
+
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="binary UART capture containing a trace dump")
+    parser.add_argument("-o", "--output", help="output JSON file (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as f:
+        data = f.read()
+
+    counts_per_second, names, events = parse(data)
+    trace = to_chrome(counts_per_second, names, events)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+    print("%d events, %d names" % (len(events), len(names)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
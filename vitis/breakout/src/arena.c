@@ -0,0 +1,130 @@
+#include "arena.h"
+
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "placement.h"
+
+#define ARENA_ROUND_UP(bytes) (((bytes) + ARENA_ALIGN - 1) & ~(u32)(ARENA_ALIGN - 1))
+
+//the frame arena is touched every frame, keep it next to the game loop
+OCM_BSS static u8 arena_frame_storage[ARENA_FRAME_BYTES] __attribute__((aligned(ARENA_ALIGN)));
+static arena_s arena_frame_arena = {"frame", arena_frame_storage, ARENA_FRAME_BYTES, 0, 0, 0};
+
+static arena_s *arena_list[ARENA_MAX_ARENAS] = {&arena_frame_arena};
+static int arena_count = 1;
+static pool_s *pool_list[ARENA_MAX_POOLS];
+static int pool_count;
+
+int arena_init(arena_s *arena, const char *name, void *buffer, u32 size){
+	u32 skip = ARENA_ROUND_UP((u32)buffer) - (u32)buffer;
+
+	if (arena_count == ARENA_MAX_ARENAS || size < skip)
+		return XST_FAILURE;
+
+	arena->name = name;
+	arena->base = (u8 *)buffer + skip;
+	arena->size = size - skip;
+	arena->used = 0;
+	arena->high_water = 0;
+	arena->failures = 0;
+	arena_list[arena_count++] = arena;
+	return XST_SUCCESS;
+}
+
+OCM_TEXT void *arena_alloc(arena_s *arena, u32 bytes){
+	u32 size = ARENA_ROUND_UP(bytes);
+	void *block;
+
+	if (size < bytes || size > arena->size - arena->used){
+		arena->failures++;
+		return NULL;
+	}
+	block = arena->base + arena->used;
+	arena->used += size;
+	if (arena->used > arena->high_water)
+		arena->high_water = arena->used;
+	return block;
+}
+
+OCM_TEXT void arena_reset(arena_s *arena){
+	arena->used = 0;
+}
+
+arena_s *arena_frame(){
+	return &arena_frame_arena;
+}
+
+int pool_init(pool_s *pool, const char *name, void *buffer, u32 object_size, u32 capacity){
+	u8 *object;
+	u32 i;
+
+	object_size = ARENA_ROUND_UP(object_size);
+	if (pool_count == ARENA_MAX_POOLS || ((u32)buffer & (ARENA_ALIGN - 1))
+			|| object_size < sizeof(void *) || capacity == 0)
+		return XST_FAILURE;
+
+	pool->name = name;
+	pool->base = buffer;
+	pool->object_size = object_size;
+	pool->capacity = capacity;
+	pool->in_use = 0;
+	pool->high_water = 0;
+	pool->failures = 0;
+
+	//thread the free list through the objects, first object first
+	pool->free_list = NULL;
+	for (i = capacity; i > 0; i--){
+		object = pool->base + (i - 1) * object_size;
+		*(void **)object = pool->free_list;
+		pool->free_list = object;
+	}
+	pool_list[pool_count++] = pool;
+	return XST_SUCCESS;
+}
+
+OCM_TEXT void *pool_alloc(pool_s *pool){
+	void *object = pool->free_list;
+
+	if (object == NULL){
+		pool->failures++;
+		return NULL;
+	}
+	pool->free_list = *(void **)object;
+	pool->in_use++;
+	if (pool->in_use > pool->high_water)
+		pool->high_water = pool->in_use;
+	return object;
+}
+
+OCM_TEXT void pool_free(pool_s *pool, void *object){
+	u32 offset = (u8 *)object - pool->base;
+
+	if (object == NULL)
+		return;
+	if ((u8 *)object < pool->base || offset >= pool->capacity * pool->object_size
+			|| offset % pool->object_size != 0){
+		xil_printf("pool %s: free of 0x%08x, not one of its objects\n\r", pool->name, (u32)object);
+		return;
+	}
+	*(void **)object = pool->free_list;
+	pool->free_list = object;
+	pool->in_use--;
+}
+
+void arena_report(){
+	arena_s *arena;
+	pool_s *pool;
+	int i;
+
+	for (i = 0; i < arena_count; i++){
+		arena = arena_list[i];
+		xil_printf("arena %s: %d bytes used, high water %d of %d bytes, %d failed\n\r",
+				arena->name, arena->used, arena->high_water, arena->size, arena->failures);
+	}
+	for (i = 0; i < pool_count; i++){
+		pool = pool_list[i];
+		xil_printf("pool %s: %d in use, high water %d of %d x %d bytes, %d failed\n\r",
+				pool->name, pool->in_use, pool->high_water, pool->capacity,
+				pool->object_size, pool->failures);
+	}
+}
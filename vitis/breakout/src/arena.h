@@ -0,0 +1,72 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "xil_types.h"
+
+/*
+ * Deterministic allocation for the frame loop instead of the newlib heap:
+ *
+ * An arena hands out memory from a fixed buffer by bumping an offset and gives
+ * it all back at once on reset. The frame arena is reset at the end of every
+ * renderer_render(), so anything taken from it lives until the frame is on
+ * screen and must not be kept past that.
+ *
+ * A pool holds a fixed number of objects of one size on a free list, for
+ * things that outlive a frame. Both allocate and free in O(1) and return NULL
+ * instead of failing somewhere else when they run out, and both keep a high
+ * water mark so their sizes can be checked with arena_report().
+ */
+
+//every arena allocation and pool object is aligned to this
+#define ARENA_ALIGN        8
+#define ARENA_FRAME_BYTES  16384
+#define ARENA_MAX_ARENAS   4
+#define ARENA_MAX_POOLS    8
+
+typedef struct {
+	const char *name;
+	u8 *base;
+	u32 size;
+	u32 used;
+	u32 high_water;    //most bytes in use at once
+	u32 failures;      //allocations that did not fit
+} arena_s;
+
+typedef struct {
+	const char *name;
+	u8 *base;
+	u32 object_size;
+	u32 capacity;
+	void *free_list;
+	u32 in_use;
+	u32 high_water;    //most objects in use at once
+	u32 failures;      //allocations from an empty pool
+} pool_s;
+
+//storage for a pool of count objects of type, big and aligned enough for the free list
+#define POOL_STORAGE(storage, type, count) \
+	static union { type object; void *next; } storage[count] __attribute__((aligned(ARENA_ALIGN)))
+#define POOL_INIT(pool, name, storage) \
+	pool_init(pool, name, storage, sizeof((storage)[0]), sizeof(storage) / sizeof((storage)[0]))
+
+//typed allocations
+#define ARENA_NEW(arena, type, count) ((type *)arena_alloc(arena, sizeof(type) * (count)))
+#define POOL_NEW(pool, type)          ((type *)pool_alloc(pool))
+
+//the arena and pool structs must stay valid, they are kept for arena_report()
+int arena_init(arena_s *arena, const char *name, void *buffer, u32 size);
+void *arena_alloc(arena_s *arena, u32 bytes);
+//frees everything allocated from the arena
+void arena_reset(arena_s *arena);
+
+//arena for allocations that only live until the end of the current frame
+arena_s *arena_frame();
+
+int pool_init(pool_s *pool, const char *name, void *buffer, u32 object_size, u32 capacity);
+void *pool_alloc(pool_s *pool);
+void pool_free(pool_s *pool, void *object);
+
+//prints use, high water marks and failures of the frame arena and every registered arena and pool
+void arena_report();
+
+#endif //ARENA_H
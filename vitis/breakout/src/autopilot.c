@@ -0,0 +1,144 @@
+#include "autopilot.h"
+
+#include "input.h"
+#include "prng.h"
+
+//the ball center can travel between these two x coordinates
+#define AUTOPILOT_LEFT_X  (WALL_WIDTH + BALL_RADIUS)
+#define AUTOPILOT_RIGHT_X (SCREEN_WIDTH - WALL_WIDTH - BALL_RADIUS - 1)
+
+//closer than this to the target the paddle stops, avoids jittering around it
+#define AUTOPILOT_DEADBAND (PADDLE_SPEED / 2)
+
+static const GameState *autopilot_game;
+static autopilot_config_s autopilot_config = {
+	AUTOPILOT_DEFAULT_SKILL,
+	AUTOPILOT_DEFAULT_RANDOMNESS,
+	AUTOPILOT_DEFAULT_REACTION,
+	AUTOPILOT_DEFAULT_SEED
+};
+
+static prng_s random_prng = {AUTOPILOT_DEFAULT_SEED};
+static int target_x;       //where the paddle center should go
+static int ball_falling;   //ball direction when the target was last picked
+static u32 reaction_timer; //frames left before reacting
+
+//uniform random integer in [-range, range]
+static int random_range(int range){
+	if (range <= 0)
+		return 0;
+	return (int)(prng_next(&random_prng) % (u32)(2 * range + 1)) - range;
+}
+
+//scalar_t to Q16.16 so the prediction is the same integer math in both physics modes
+static fixed_t to_fixed(scalar_t v){
+#ifdef BREAKOUT_FIXED_POINT
+	return v;
+#else
+	return (fixed_t)(v * FIXED_ONE);
+#endif
+}
+
+//x position of the ball when it reaches the paddle, folding in wall bounces
+static int predict_landing_x(const GameState *game){
+	fixed_t dy = to_fixed(game->paddle.y - SCALAR(BALL_RADIUS)) - to_fixed(game->ball.y);
+	fixed_t vy = to_fixed(game->ball.vy);
+	fixed_t vx = to_fixed(game->ball.vx);
+	s64 x;
+	int width = AUTOPILOT_RIGHT_X - AUTOPILOT_LEFT_X;
+	int rel;
+
+	if (vy <= 0 || dy <= 0)
+		return SCALAR_TO_INT(game->ball.x);
+
+	//x after the dy / vy frames it takes to fall to the paddle, in whole pixels
+	x = (s64)to_fixed(game->ball.x) + (s64)vx * dy / vy;
+	rel = (int)(x >> FIXED_SHIFT) - AUTOPILOT_LEFT_X;
+
+	//the walls mirror the path, so fold it into one period of 2 * width
+	rel %= 2 * width;
+	if (rel < 0)
+		rel += 2 * width;
+	if (rel > width)
+		rel = 2 * width - rel;
+
+	return AUTOPILOT_LEFT_X + rel;
+}
+
+static void pick_target(const GameState *game){
+	int error_range = (int)(100 - autopilot_config.skill) * PADDLE_WIDTH / 100;
+	//stay inside the paddle: at 100 randomness hit up to 80% of the way to the edge
+	int aim_range = (int)autopilot_config.randomness * (PADDLE_WIDTH / 2) * 8 / 1000;
+
+	target_x = predict_landing_x(game) + random_range(error_range) - random_range(aim_range);
+}
+
+void autopilot_attach(const GameState *game){
+	autopilot_game = game;
+	ball_falling = FALSE;
+	reaction_timer = autopilot_config.reaction_frames;
+	target_x = SCREEN_WIDTH / 2;
+}
+
+void autopilot_configure(const autopilot_config_s *config){
+	if (config == NULL){
+		autopilot_config.skill = AUTOPILOT_DEFAULT_SKILL;
+		autopilot_config.randomness = AUTOPILOT_DEFAULT_RANDOMNESS;
+		autopilot_config.reaction_frames = AUTOPILOT_DEFAULT_REACTION;
+		autopilot_config.seed = AUTOPILOT_DEFAULT_SEED;
+	}
+	else {
+		autopilot_config = *config;
+		if (autopilot_config.skill > 100)
+			autopilot_config.skill = 100;
+		if (autopilot_config.randomness > 100)
+			autopilot_config.randomness = 100;
+	}
+
+	prng_seed(&random_prng, autopilot_config.seed);
+	reaction_timer = autopilot_config.reaction_frames;
+}
+
+u32 autopilot_read_buttons(){
+	const GameState *game = autopilot_game;
+	int falling;
+	int paddle_center;
+	u32 buttons = 0;
+
+	if (game == NULL)
+		return 0;
+
+	//launch after the reaction time, like a person would
+	if (!game->ball_launched){
+		if (reaction_timer > 0){
+			reaction_timer--;
+			return 0;
+		}
+		reaction_timer = autopilot_config.reaction_frames;
+		return INPUT_BTN_LAUNCH;
+	}
+
+	//re-plan when the ball changes vertical direction, after the reaction time
+	falling = game->ball.vy > 0;
+	if (falling != ball_falling){
+		if (reaction_timer > 0){
+			reaction_timer--;
+		}
+		else {
+			ball_falling = falling;
+			reaction_timer = autopilot_config.reaction_frames;
+			if (falling)
+				pick_target(game);
+			else
+				target_x = SCREEN_WIDTH / 2;
+		}
+	}
+
+	paddle_center = SCALAR_TO_INT(game->paddle.x) + PADDLE_WIDTH / 2;
+	if (paddle_center < target_x - AUTOPILOT_DEADBAND)
+		buttons = INPUT_BTN_RIGHT;
+	else if (paddle_center > target_x + AUTOPILOT_DEADBAND)
+		buttons = INPUT_BTN_LEFT;
+
+	return buttons;
+}
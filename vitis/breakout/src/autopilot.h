@@ -0,0 +1,33 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include "xil_types.h"
+#include "breakout_game.h"
+
+/*
+ * Computer player that presses the same four buttons a person would.
+ * It predicts where the ball will cross the paddle row (including wall
+ * bounces) and moves the paddle there, so unattended runs can go for hours.
+ * Select it with input_set_source(INPUT_SOURCE_AUTOPILOT).
+ */
+
+typedef struct {
+	u32 skill;           //0-100, at 100 the predicted landing spot is exact
+	u32 randomness;      //0-100, how far from the paddle center it deliberately hits the ball
+	u32 reaction_frames; //frames between seeing a new ball direction and reacting to it
+	u32 seed;            //seed for the skill error and aim, same seed = same game
+} autopilot_config_s;
+
+#define AUTOPILOT_DEFAULT_SKILL      100
+#define AUTOPILOT_DEFAULT_RANDOMNESS 60
+#define AUTOPILOT_DEFAULT_REACTION   4
+#define AUTOPILOT_DEFAULT_SEED       0xB4EA4
+
+//the game whose ball and paddle the autopilot watches
+void autopilot_attach(const GameState *game);
+//NULL restores the defaults above
+void autopilot_configure(const autopilot_config_s *config);
+//button state for this frame, in the same format as the push buttons
+u32 autopilot_read_buttons();
+
+#endif //AUTOPILOT_H
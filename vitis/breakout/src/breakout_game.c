@@ -1,5 +1,72 @@
 #include "breakout_game.h"
 
+/*
+ * Input trace options (see input.h), at most one of:
+ *   RECORD_INPUT - record the buttons every frame and dump the trace over UART at game over
+ *   REPLAY_INPUT - wait for a trace over UART at start and play it back instead of the buttons
+ */
+//#define RECORD_INPUT
+//#define REPLAY_INPUT
+
+/*
+ * Uncomment to let the autopilot (see autopilot.h) play instead of the buttons.
+ * The game restarts whenever it ends, so it can soak for hours unattended.
+ */
+//#define AUTOPILOT
+
+/*
+ * Uncomment to trace every profiler zone from the start of the game and dump
+ * the trace over UART at game over (convert it with tools/trace_to_chrome.py)
+ */
+//#define TRACE_FRAMES
+
+/*
+ * Uncomment to count PMU events (see pmu.h) in every profiler zone, including
+ * the renderer's flush and clear, and print them with the periodic report
+ */
+//#define PROFILE_PMU
+
+/*
+ * Uncomment to estimate the DDR traffic of the clear, draw and flush phases
+ * from the L2 cache event counters (see l2_counters.h) in the periodic report
+ */
+//#define PROFILE_L2
+
+/*
+ * Uncomment to sample the PC at SAMPLER_DEFAULT_HZ (see sampler.h), print the
+ * hottest addresses in the periodic report and dump the histogram over UART at
+ * game over (symbolize it with tools/symbolize_samples.py)
+ */
+//#define PROFILE_SAMPLES
+
+/*
+ * Uncomment to graph the input, update, render and display times of every frame
+ * against the frame budget in the left wall (see overlay.h)
+ */
+//#define FRAME_GRAPH
+
+/*
+ * Uncomment to let the resolution governor (see governor.h) drop to a cheaper
+ * video mode when frames keep overrunning the budget
+ */
+//#define RESOLUTION_GOVERNOR
+
+/*
+ * Uncomment to measure the motion-to-photon latency from a button press to the
+ * display fetching the first frame rendered after it (see latency.h), with a
+ * histogram in the periodic report and at game over
+ */
+//#define MEASURE_LATENCY
+
+/*
+ * GameState snapshot options (see snapshot.h):
+ *   SNAPSHOT_RING - keep an image of each of the last SNAPSHOT_RING_SIZE frames and
+ *                   dump them over UART at game over
+ *   SNAPSHOT_LOAD - wait for a snapshot over UART at start and play on from it
+ */
+//#define SNAPSHOT_RING
+//#define SNAPSHOT_LOAD
+
 /*
  * IMPORTANT: To get math functions to work, you must link them in the project build settings.
  * 1. Right-Click "breakout" application project and go to properties
@@ -9,7 +76,9 @@
  *
  * More info: https://adaptivesupport.amd.com/s/article/52971?language=en_US
  */
+#ifndef BREAKOUT_FIXED_POINT
 #include <math.h>
+#endif
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -18,43 +87,49 @@
 //#include <unistd.h>
 
 #include "xil_printf.h"
+#include "xstatus.h"
 #include "xtime_l.h"
-#include "sleep.h"
 
 // ============================================================================
 // INCLUDE RENDERER HEADERS
 // ============================================================================
 #include "renderer.h"
 #include "profiler.h"
+#include "input.h"
+#include "autopilot.h"
+#include "trace.h"
+#include "l2_counters.h"
+#include "sampler.h"
+#include "deadline.h"
+#include "overlay.h"
+#include "governor.h"
+#include "buttons.h"
+#include "latency.h"
+#include "snapshot.h"
+#include "frameclock.h"
+#include "scheduler.h"
+#include "placement.h"
+#include "cache_profile.h"
+#include "arena.h"
+#include "footprint.h"
+#include "console.h"
 
 // ============================================================================
 // CONSTANTS AND DEFINES
 // ============================================================================
-#define SCREEN_WIDTH  1920
-#define SCREEN_HEIGHT 1080
-
 #define FPS           60
 #define FRAME_DELAY_US (1000000 / FPS) // in microseconds
 
-// Game objects
-#define PADDLE_WIDTH   100
-#define PADDLE_HEIGHT  15
-#define PADDLE_SPEED   6
-#define PADDLE_Y       (SCREEN_HEIGHT - 40)
-
-#define BALL_RADIUS    7
-#define BALL_SPEED     6
+// Headless benchmark
+#define HEADLESS_SEED       0x1234567
+#define HEADLESS_BUCKET_NS  100  // tick latency histogram resolution
+#define HEADLESS_BUCKETS    256  // the last bucket collects every slower tick
 
-#define BRICK_WIDTH    75
-#define BRICK_HEIGHT   15
-#define BRICK_ROWS     4
-#define BRICK_COLS     10
-#define BRICK_PADDING  5
-
-#define MAX_LIVES      3
-
-#define WALL_WIDTH     480
+#ifdef BREAKOUT_FIXED_POINT
+#define MAX_ANGLE      FIXED_DEGREES(45)    // in binary angle units
+#else
 #define MAX_ANGLE      (45 * M_PI / 180.0)  // in radians
+#endif
 
 // Color format: RGB (8-bit each)
 #define COLOR_BLACK_R  0
@@ -73,54 +148,40 @@
 #define COLOR_RED_G    0
 #define COLOR_RED_B    0
 
-// ============================================================================
-// DATA STRUCTURES
-// ============================================================================
-typedef struct {
-    float x;
-    float y;
-    float vx; // velocity x
-    float vy; // velocity y
-} Ball;
-
-typedef struct {
-    float x;
-    float y;
-    float vx;
-} Paddle;
-
-typedef struct {
-    float x;
-    float y;
-    int   alive;
-} Brick;
-
-typedef struct {
-    Ball   ball;
-    Paddle paddle;
-    Brick  bricks[BRICK_ROWS * BRICK_COLS];
-    int    score;
-    int    lives;
-    int    bricks_remaining;
-    int    game_running;
-    int    ball_launched;
-} GameState;
-
 // ============================================================================
 // INITIALIZATION FUNCTIONS
 // ============================================================================
 
 profiler_s profiler_breakout[10];
 
+// Event prints are turned off by the headless benchmark so UART output
+// does not end up in the measured tick time
+static int print_events = 1;
+
+// Tunables, changed from the UART console while the game runs (see console.h)
+static s32 frame_rate        = FPS;
+static s32 frame_delay_us    = FRAME_DELAY_US;
+static s32 ball_speed        = BALL_SPEED;
+static s32 clear_grey        = 100;
+static s32 report_interval_s = 3; // seconds between debug prints
+static s32 frame_buffers;
+static s32 profiler_window;
+#if defined(FRAME_GRAPH)
+static s32 frame_graph       = 1;
+#endif
+#if defined(RESOLUTION_GOVERNOR)
+static s32 governor_on       = 1;
+#endif
+
 void init_game(GameState *game) {
     // Initialize paddle
-    game->paddle.x  = SCREEN_WIDTH / 2 - PADDLE_WIDTH / 2;
-    game->paddle.y  = PADDLE_Y;
+    game->paddle.x  = SCALAR(SCREEN_WIDTH / 2 - PADDLE_WIDTH / 2);
+    game->paddle.y  = SCALAR(PADDLE_Y);
     game->paddle.vx = 0;
 
     // Initialize ball
-    game->ball.x  = game->paddle.x + PADDLE_WIDTH / 2;
-    game->ball.y  = game->paddle.y - BALL_RADIUS - 5;
+    game->ball.x  = game->paddle.x + SCALAR(PADDLE_WIDTH / 2);
+    game->ball.y  = game->paddle.y - SCALAR(BALL_RADIUS + 5);
     game->ball.vx = 0;
     game->ball.vy = 0;
 
@@ -131,9 +192,9 @@ void init_game(GameState *game) {
     for (int row = 0; row < BRICK_ROWS; row++) {
         for (int col = 0; col < BRICK_COLS; col++) {
             game->bricks[brick_index].x     =
-                brick_offset + col * (BRICK_WIDTH + BRICK_PADDING) + BRICK_PADDING;
+                SCALAR(brick_offset + col * (BRICK_WIDTH + BRICK_PADDING) + BRICK_PADDING);
             game->bricks[brick_index].y     =
-                row * (BRICK_HEIGHT + BRICK_PADDING) + 60;
+                SCALAR(row * (BRICK_HEIGHT + BRICK_PADDING) + 60);
             game->bricks[brick_index].alive = 1;
             brick_index++;
         }
@@ -149,44 +210,59 @@ void init_game(GameState *game) {
 // ============================================================================
 // INPUT HANDLING
 // ============================================================================
-void handle_input_zynq(GameState *game) {
-	volatile static unsigned int buttons;
-	buttons = *(unsigned int*)0x41210000;
+OCM_TEXT void handle_input_zynq(GameState *game) {
+	u32 buttons = input_read_buttons();
+
+#if defined(MEASURE_LATENCY)
+	latency_input(buttons);
+#endif
+
+	// A replayed trace ends the game when it runs out
+	if (input_get_source() == INPUT_SOURCE_REPLAY && input_replay_done()) {
+		xil_printf("Input replay finished\n\r");
+		game->game_running = 0;
+		return;
+	}
 
 	game->paddle.vx = 0;
-	if (buttons & 0b1000)
-		game->paddle.vx = -PADDLE_SPEED;
-	else if (buttons & 0b0001)
-		game->paddle.vx = PADDLE_SPEED;
+	if (buttons & INPUT_BTN_LEFT)
+		game->paddle.vx = SCALAR(-PADDLE_SPEED);
+	else if (buttons & INPUT_BTN_RIGHT)
+		game->paddle.vx = SCALAR(PADDLE_SPEED);
 
-	if (!game->ball_launched && (buttons & 0b0110)){
+	if (!game->ball_launched && (buttons & INPUT_BTN_LAUNCH)){
 		game->ball_launched = TRUE;
 		game->ball.vx = 0;
-		game->ball.vy = -BALL_SPEED;
+		game->ball.vy = SCALAR(-ball_speed);
 	}
 }
 
 // ============================================================================
 // COLLISION DETECTION
 // ============================================================================
-int check_rect_collision(float x1, float y1, float w1, float h1,
-                         float x2, float y2, float w2, float h2) {
+OCM_TEXT int check_rect_collision(scalar_t x1, scalar_t y1, scalar_t w1, scalar_t h1,
+                         scalar_t x2, scalar_t y2, scalar_t w2, scalar_t h2) {
     return (x1 < x2 + w2 &&
             x1 + w1 > x2 &&
             y1 < y2 + h2 &&
             y1 + h1 > y2);
 }
 
-int check_circle_rect_collision(float cx, float cy, float r,
-                                float rx, float ry, float rw, float rh) {
-    float closest_x = (cx < rx)       ? rx :
-                      (cx > rx + rw)  ? rx + rw : cx;
-    float closest_y = (cy < ry)       ? ry :
-                      (cy > ry + rh)  ? ry + rh : cy;
-
-    float dx   = cx - closest_x;
-    float dy   = cy - closest_y;
+OCM_TEXT int check_circle_rect_collision(scalar_t cx, scalar_t cy, scalar_t r,
+                                scalar_t rx, scalar_t ry, scalar_t rw, scalar_t rh) {
+    scalar_t closest_x = (cx < rx)       ? rx :
+                         (cx > rx + rw)  ? rx + rw : cx;
+    scalar_t closest_y = (cy < ry)       ? ry :
+                         (cy > ry + rh)  ? ry + rh : cy;
+
+    scalar_t dx   = cx - closest_x;
+    scalar_t dy   = cy - closest_y;
+#ifdef BREAKOUT_FIXED_POINT
+    // Squares of Q16.16 distances overflow 32 bits, compare them in Q32.32
+    return (s64)dx*dx + (s64)dy*dy < (s64)r*r;
+#else
     return dx*dx + dy*dy < r*r;
+#endif
 //    float dist = sqrt(dx * dx + dy * dy);
 //    return dist < r;
 
@@ -195,15 +271,15 @@ int check_circle_rect_collision(float cx, float cy, float r,
 // ============================================================================
 // GAME UPDATE
 // ============================================================================
-void reset_ball_on_paddle(GameState *game) {
+OCM_TEXT void reset_ball_on_paddle(GameState *game) {
     game->ball_launched = 0;
-    game->ball.x        = game->paddle.x + PADDLE_WIDTH / 2;
-    game->ball.y        = game->paddle.y - BALL_RADIUS - 5;
+    game->ball.x        = game->paddle.x + SCALAR(PADDLE_WIDTH / 2);
+    game->ball.y        = game->paddle.y - SCALAR(BALL_RADIUS + 5);
     game->ball.vx       = 0;
     game->ball.vy       = 0;
 }
 
-void update_game(GameState *game) {
+OCM_TEXT void update_game(GameState *game) {
     if (!game->game_running) {
         return;
     }
@@ -212,15 +288,15 @@ void update_game(GameState *game) {
     game->paddle.x += game->paddle.vx;
 
     // Keep paddle in bounds
-    if (game->paddle.x < WALL_WIDTH)
-        game->paddle.x = WALL_WIDTH;
-    if (game->paddle.x + PADDLE_WIDTH >= SCREEN_WIDTH - WALL_WIDTH)
-        game->paddle.x = SCREEN_WIDTH - WALL_WIDTH - PADDLE_WIDTH - 1;
+    if (game->paddle.x < SCALAR(WALL_WIDTH))
+        game->paddle.x = SCALAR(WALL_WIDTH);
+    if (game->paddle.x + SCALAR(PADDLE_WIDTH) >= SCALAR(SCREEN_WIDTH - WALL_WIDTH))
+        game->paddle.x = SCALAR(SCREEN_WIDTH - WALL_WIDTH - PADDLE_WIDTH - 1);
 
     // If ball not launched, keep it on paddle
     if (!game->ball_launched) {
-        game->ball.x = game->paddle.x + PADDLE_WIDTH / 2;
-        game->ball.y = game->paddle.y - BALL_RADIUS - 5;
+        game->ball.x = game->paddle.x + SCALAR(PADDLE_WIDTH / 2);
+        game->ball.y = game->paddle.y - SCALAR(BALL_RADIUS + 5);
         return;
     }
 
@@ -229,23 +305,42 @@ void update_game(GameState *game) {
     game->ball.y += game->ball.vy;
 
     // Ball collision with walls
-    if (game->ball.x - BALL_RADIUS < WALL_WIDTH) {
-        game->ball.x  = BALL_RADIUS + WALL_WIDTH;
+    if (game->ball.x - SCALAR(BALL_RADIUS) < SCALAR(WALL_WIDTH)) {
+        game->ball.x  = SCALAR(BALL_RADIUS + WALL_WIDTH);
         game->ball.vx = -game->ball.vx;
     }
-    if (game->ball.x + BALL_RADIUS >= SCREEN_WIDTH - WALL_WIDTH) {
-        game->ball.x  = SCREEN_WIDTH - WALL_WIDTH - BALL_RADIUS - 1;
+    if (game->ball.x + SCALAR(BALL_RADIUS) >= SCALAR(SCREEN_WIDTH - WALL_WIDTH)) {
+        game->ball.x  = SCALAR(SCREEN_WIDTH - WALL_WIDTH - BALL_RADIUS - 1);
         game->ball.vx = -game->ball.vx;
     }
-    if (game->ball.y - BALL_RADIUS < 0) {
-        game->ball.y  = BALL_RADIUS;
+    if (game->ball.y - SCALAR(BALL_RADIUS) < 0) {
+        game->ball.y  = SCALAR(BALL_RADIUS);
         game->ball.vy = -game->ball.vy;
     }
 
     // Ball collision with paddle
-    if (check_circle_rect_collision(game->ball.x, game->ball.y, BALL_RADIUS,
+    if (check_circle_rect_collision(game->ball.x, game->ball.y, SCALAR(BALL_RADIUS),
                                     game->paddle.x, game->paddle.y,
-                                    PADDLE_WIDTH, PADDLE_HEIGHT)) {
+                                    SCALAR(PADDLE_WIDTH), SCALAR(PADDLE_HEIGHT))) {
+#ifdef BREAKOUT_FIXED_POINT
+    	fixed_t vx = game->ball.vx;
+    	fixed_t vy = game->ball.vy;
+    	fixed_t spd = fixed_sqrt(FIXED_MUL(vx, vx) + FIXED_MUL(vy, vy));
+
+        game->ball.y  = game->paddle.y - SCALAR(BALL_RADIUS + 5);
+
+        //get x offset between ball center and paddle center
+        int offset = SCALAR_TO_INT(game->ball.x - (game->paddle.x + SCALAR(PADDLE_WIDTH/2)));
+        if (offset > PADDLE_WIDTH/2) offset = PADDLE_WIDTH/2;
+        if (offset < -PADDLE_WIDTH/2) offset = -PADDLE_WIDTH/2;
+        if (print_events)
+            xil_printf("ball offset = %d\n\r", offset);
+
+        //range will be [-MAX_ANGLE, MAX_ANGLE], looked up in the sine table
+        int angle = MAX_ANGLE * offset / (PADDLE_WIDTH/2);
+        game->ball.vy = -FIXED_MUL(spd, fixed_cos(angle));
+        game->ball.vx = FIXED_MUL(spd, fixed_sin(angle));
+#else
     	float vx = game->ball.vx;
     	float vy = game->ball.vy;
     	float spd = sqrt(vx*vx + vy*vy);
@@ -259,12 +354,14 @@ void update_game(GameState *game) {
         float magnitude = 1.0 * offset / (PADDLE_WIDTH/2);
         if (magnitude > 1.0) magnitude = 1.0;
         if (magnitude < -1.0) magnitude = -1.0;
-        printf("ball offset = %d, magnitude = %f\n\r", offset, magnitude);
+        if (print_events)
+            printf("ball offset = %d, magnitude = %f\n\r", offset, magnitude);
 
         //range will be [-MAX_ANGLE, MAX_ANGLE]
         float angle = MAX_ANGLE * magnitude;
         game->ball.vy = -spd * cos(angle);
         game->ball.vx = spd * sin(angle);
+#endif
 
 
 //        if (game->paddle.vx != 0) {
@@ -275,16 +372,17 @@ void update_game(GameState *game) {
     // Ball collision with bricks
     for (int i = 0; i < BRICK_ROWS * BRICK_COLS; i++) {
         if (game->bricks[i].alive) {
-            if (check_circle_rect_collision(game->ball.x, game->ball.y, BALL_RADIUS,
+            if (check_circle_rect_collision(game->ball.x, game->ball.y, SCALAR(BALL_RADIUS),
                                             game->bricks[i].x, game->bricks[i].y,
-                                            BRICK_WIDTH, BRICK_HEIGHT)) {
+                                            SCALAR(BRICK_WIDTH), SCALAR(BRICK_HEIGHT))) {
                 game->bricks[i].alive = 0;
                 game->bricks_remaining--;
                 game->ball.vy = -game->ball.vy;
                 game->score  += 10;
 
                 if (game->bricks_remaining <= 0) {
-                    xil_printf("You win! Final score: %d\n\r", game->score);
+                    if (print_events)
+                        xil_printf("You win! Final score: %d\n\r", game->score);
                     game->game_running = 0;
                 }
                 break;
@@ -293,14 +391,16 @@ void update_game(GameState *game) {
     }
 
     // Ball goes out of bounds (bottom) -> lose a life
-    if (game->ball.y - BALL_RADIUS > SCREEN_HEIGHT) {
+    if (game->ball.y - SCALAR(BALL_RADIUS) > SCALAR(SCREEN_HEIGHT)) {
         game->lives--;
 
         if (game->lives > 0) {
-            xil_printf("Life lost! Lives remaining: %d\n\r", game->lives);
+            if (print_events)
+                xil_printf("Life lost! Lives remaining: %d\n\r", game->lives);
             reset_ball_on_paddle(game);
         } else {
-            xil_printf("Game Over! You lost. Final score: %d\n\r", game->score);
+            if (print_events)
+                xil_printf("Game Over! You lost. Final score: %d\n\r", game->score);
             game->game_running = 0;
         }
     }
@@ -309,7 +409,7 @@ void update_game(GameState *game) {
 // ============================================================================
 // DRAWING PRIMITIVES (using renderer_draw_pixel)
 // ============================================================================
-void draw_rect(int x, int y, int w, int h, u8 r, u8 g, u8 b) {
+OCM_TEXT void draw_rect(int x, int y, int w, int h, u8 r, u8 g, u8 b) {
     for (int py = y; py < y + h; py++) {
         for (int px = x; px < x + w; px++) {
             if (px >= 0 && px < SCREEN_WIDTH &&
@@ -320,7 +420,7 @@ void draw_rect(int x, int y, int w, int h, u8 r, u8 g, u8 b) {
     }
 }
 
-void draw_filled_circle(int cx, int cy, int radius, u8 r, u8 g, u8 b) {
+OCM_TEXT void draw_filled_circle(int cx, int cy, int radius, u8 r, u8 g, u8 b) {
     for (int y = -radius; y <= radius; y++) {
         for (int x = -radius; x <= radius; x++) {
             if (x * x + y * y <= radius * radius) {
@@ -338,67 +438,240 @@ void draw_filled_circle(int cx, int cy, int radius, u8 r, u8 g, u8 b) {
 // ============================================================================
 // RENDERING TO HDMI
 // ============================================================================
-void render_game_hdmi(GameState *game) {
+// Game coordinates are 1920x1080, lower video modes draw them scaled down
+static int render_scale_num = SCREEN_WIDTH;
+static const int render_scale_den = SCREEN_WIDTH;
+
+static inline int to_screen(int v) {
+    return v * render_scale_num / render_scale_den;
+}
+
+// Scales both edges so neighbouring rects still meet after rounding
+OCM_TEXT static void draw_game_rect(int x, int y, int w, int h, u8 r, u8 g, u8 b) {
+    draw_rect(to_screen(x), to_screen(y),
+              to_screen(x + w) - to_screen(x), to_screen(y + h) - to_screen(y),
+              r, g, b);
+}
+
+OCM_TEXT void render_game_hdmi(GameState *game) {
+    const VideoMode *mode = renderer_get_mode();
+
+    render_scale_num = mode->width;
+
     // Screen is already cleared to grey from render_render() call
 	// Draw the black void in between the walls
-	for (int y = 0; y < SCREEN_HEIGHT; y++){
+	for (int y = 0; y < (int)mode->height; y++){
 		renderer_draw_grey_row(
-				WALL_WIDTH + 1,
+				to_screen(WALL_WIDTH + 1),
 				y,
-				SCREEN_WIDTH - (WALL_WIDTH * 2) - 2,
+				to_screen(SCREEN_WIDTH - WALL_WIDTH - 1) - to_screen(WALL_WIDTH + 1),
 				0
 		);
 	}
 
 
     // Draw paddle (cyan)
-    draw_rect((int)game->paddle.x, (int)game->paddle.y,
-              PADDLE_WIDTH, PADDLE_HEIGHT,
-              COLOR_CYAN_R, COLOR_CYAN_G, COLOR_CYAN_B);
+    draw_game_rect(SCALAR_TO_INT(game->paddle.x), SCALAR_TO_INT(game->paddle.y),
+                   PADDLE_WIDTH, PADDLE_HEIGHT,
+                   COLOR_CYAN_R, COLOR_CYAN_G, COLOR_CYAN_B);
 
     // Draw ball (white)
-    draw_filled_circle((int)game->ball.x, (int)game->ball.y,
-                       BALL_RADIUS,
+    draw_filled_circle(to_screen(SCALAR_TO_INT(game->ball.x)), to_screen(SCALAR_TO_INT(game->ball.y)),
+                       to_screen(BALL_RADIUS),
                        COLOR_WHITE_R, COLOR_WHITE_G, COLOR_WHITE_B);
 
     // Draw bricks (red)
     for (int i = 0; i < BRICK_ROWS * BRICK_COLS; i++) {
         if (game->bricks[i].alive) {
-            draw_rect((int)game->bricks[i].x, (int)game->bricks[i].y,
-                      BRICK_WIDTH, BRICK_HEIGHT,
-                      COLOR_RED_R, COLOR_RED_G, COLOR_RED_B);
+            draw_game_rect(SCALAR_TO_INT(game->bricks[i].x), SCALAR_TO_INT(game->bricks[i].y),
+                           BRICK_WIDTH, BRICK_HEIGHT,
+                           COLOR_RED_R, COLOR_RED_G, COLOR_RED_B);
         }
     }
 
     //draw lives display (cyan)
     for (int i = 0; i < game->lives; i++){
-    	draw_rect(WALL_WIDTH + 10 + (20 + 10) * i, 10, 20, 20, 0, 255, 255);
+    	draw_game_rect(WALL_WIDTH + 10 + (20 + 10) * i, 10, 20, 20, 0, 255, 255);
     }
 
     // Print game state to UART for debugging
     static int print_counter = 0;
     print_counter++;
     if (print_counter % 60 == 0) {
-        xil_printf("Score: %d | Lives: %d | Bricks: %d | Ball: (%.0f, %.0f)\n\r",
+        xil_printf("Score: %d | Lives: %d | Bricks: %d | Ball: (%d, %d)\n\r",
                    game->score, game->lives, game->bricks_remaining,
-                   game->ball.x, game->ball.y);
+                   SCALAR_TO_INT(game->ball.x), SCALAR_TO_INT(game->ball.y));
     }
 }
 
+// ============================================================================
+// TUNING CONSOLE
+// ============================================================================
+static void apply_frame_rate(s32 value) {
+    // The frame graph and the governor keep the budget they started with
+    frame_delay_us = 1000000 / value;
+    frameclock_set_period(frame_delay_us);
+}
+
+static void apply_frame_buffers(s32 value) {
+    renderer_set_buffer_count(value);
+}
+
+static void apply_profiler_window(s32 value) {
+    profiler_set_window(value);
+}
+
+#if defined(FRAME_GRAPH)
+static void apply_frame_graph(s32 value) {
+    overlay_enable(value);
+}
+#endif
+
+#if defined(RESOLUTION_GOVERNOR)
+static void apply_governor(s32 value) {
+    governor_enable(value);
+}
+#endif
+
+static void report_profiler() {
+    profiler_report_header();
+    profiler_report(profiler_breakout, 6);
+}
+
+static void console_register() {
+    frame_buffers   = renderer_get_buffer_count();
+    profiler_window = profiler_get_window();
+
+    console_add_tunable("fps", "frame rate", &frame_rate, 10, 240, apply_frame_rate);
+    console_add_tunable("ball_speed", "launch speed, pixels per frame", &ball_speed, 1, 20, NULL);
+    console_add_tunable("clear_grey", "background grey level", &clear_grey, 0, 255, NULL);
+    console_add_tunable("report_s", "seconds between debug prints", &report_interval_s, 1, 600, NULL);
+    console_add_tunable("buffers", "frame buffers drawn in turn", &frame_buffers,
+                        2, renderer_get_buffer_count(), apply_frame_buffers);
+    console_add_tunable("window", "profiler window, frames", &profiler_window,
+                        1, PROFILER_MAX_WINDOW, apply_profiler_window);
+#if defined(FRAME_GRAPH)
+    console_add_tunable("graph", "frame time graph on/off", &frame_graph, 0, 1, apply_frame_graph);
+#endif
+#if defined(RESOLUTION_GOVERNOR)
+    console_add_tunable("governor", "resolution governor on/off", &governor_on, 0, 1, apply_governor);
+#endif
+
+    console_add_stats("profiler", report_profiler);
+    console_add_stats("frameclock", frameclock_print);
+    console_add_stats("scheduler", scheduler_report);
+    console_add_stats("deadline", deadline_print);
+    console_add_stats("buttons", buttons_print);
+    console_add_stats("arena", arena_report);
+    console_add_stats("footprint", footprint_report);
+    console_add_stats("placement", placement_report);
+    console_add_stats("cache", cache_profile_report);
+#if defined(MEASURE_LATENCY)
+    console_add_stats("latency", latency_report);
+#endif
+    console_initialize();
+}
+
 // ============================================================================
 // MAIN BREAKOUT GAME LOOP
 // ============================================================================
-void breakout_game_run() {
+OCM_TEXT void breakout_game_run() {
     GameState game;
     init_game(&game);
 
     xil_printf("Breakout Game Started!\n\r");
     xil_printf("Screen: %d x %d\n\r", SCREEN_WIDTH, SCREEN_HEIGHT);
+    placement_report();
 
     long frame_counter         = 0;
-    int  debug_update_interval = 3; // Print debug every 3 seconds
+
+    // Zones 1-4 nest inside the frame zone
+    profiler_init(&profiler_breakout[0], "frame");
+    profiler_init(&profiler_breakout[1], "input");
+    profiler_init(&profiler_breakout[2], "update");
+    profiler_init(&profiler_breakout[3], "render");
+    profiler_init(&profiler_breakout[4], "display");
+    profiler_init(&profiler_breakout[5], "sleep");
+
+#if defined(FRAME_GRAPH)
+    profiler_s *graph_zones[] = {
+        &profiler_breakout[1], &profiler_breakout[2],
+        &profiler_breakout[3], &profiler_breakout[4]
+    };
+    overlay_initialize(graph_zones, 4, FRAME_DELAY_US);
+    overlay_enable(1);
+#endif
+
+#if defined(RESOLUTION_GOVERNOR)
+    governor_initialize(FRAME_DELAY_US);
+    governor_enable(1);
+#endif
+
+    // Log every frame whose work overruns its budget
+    deadline_initialize(&game);
+
+    // Sample the buttons between frames so short presses are not lost
+    buttons_initialize();
+
+#if defined(PROFILE_PMU)
+    profiler_enable_pmu(1);
+#endif
+#if defined(PROFILE_L2)
+    l2_counters_enable(1);
+#endif
+
+#if defined(PROFILE_SAMPLES)
+    sampler_start(SAMPLER_DEFAULT_HZ);
+#endif
+
+#if defined(MEASURE_LATENCY)
+    latency_initialize();
+#endif
+
+#if defined(TRACE_FRAMES)
+    trace_clear();
+    trace_start();
+#endif
+
+#if defined(AUTOPILOT)
+    autopilot_configure(NULL);
+    autopilot_attach(&game);
+    input_set_source(INPUT_SOURCE_AUTOPILOT);
+#endif
+
+#if defined(REPLAY_INPUT)
+    xil_printf("Waiting for input recording over UART...\n\r");
+    if (input_record_load_uart() == XST_SUCCESS) {
+        xil_printf("Replaying %d frames\n\r", input_record_frames());
+        input_set_source(INPUT_SOURCE_REPLAY);
+    }
+#elif defined(RECORD_INPUT)
+    input_record_start();
+#endif
+
+#if defined(SNAPSHOT_LOAD)
+    snapshot_s start_image;
+    xil_printf("Waiting for a snapshot over UART...\n\r");
+    if (snapshot_load_uart(&start_image) == XST_SUCCESS) {
+        XTime restore_start, restore_end;
+        XTime_GetTime(&restore_start);
+        int status = snapshot_restore(&start_image, &game);
+        XTime_GetTime(&restore_end);
+        if (status == XST_SUCCESS)
+            xil_printf("Starting from frame %d (restored in %d us)\n\r", start_image.frame,
+                       (u32)((restore_end - restore_start) * 1000000 / COUNTS_PER_SECOND));
+    }
+#endif
+
+    // The first deadline is one frame from here, after any waiting on the UART
+    frameclock_initialize(FRAME_DELAY_US);
+    // Background tasks get the rest of each frame (see scheduler.h)
+    scheduler_initialize();
+    // Tunables and stats over the UART, polled as a background task
+    console_register();
 
     while (game.game_running) {
+        deadline_arm(frame_counter, frame_delay_us);
         profiler_start(&profiler_breakout[0]);
 
         // Input handling
@@ -410,44 +683,215 @@ void breakout_game_run() {
         profiler_start(&profiler_breakout[2]);
         update_game(&game);
         profiler_end(&profiler_breakout[2]);
+#if defined(SNAPSHOT_RING)
+        snapshot_ring_push(&game, frame_counter);
+#endif
 
         // Render to HDMI
         profiler_start(&profiler_breakout[3]);
+        l2_counters_begin(L2_PHASE_DRAW);
         render_game_hdmi(&game);
+        overlay_draw();
+        l2_counters_end(L2_PHASE_DRAW);
         profiler_end(&profiler_breakout[3]);
 
         // Push frame to display
         profiler_start(&profiler_breakout[4]);
-        renderer_render(100);
+#if defined(MEASURE_LATENCY)
+        latency_submit(renderer_get_frame_index());
+#endif
+        renderer_render(clear_grey);
         profiler_end(&profiler_breakout[4]);
 
+        // The frame's work ends here, the blocking report below is not part of it
+        profiler_end(&profiler_breakout[0]);
+        deadline_disarm();
+        overlay_sample();
+#if defined(RESOLUTION_GOVERNOR)
+        governor_update(profiler_breakout[0].elapsed_us);
+#endif
+
         // Debug profiler prints
         frame_counter++;
-        if (frame_counter % (FPS * debug_update_interval) == 0) {
+        if (frame_counter % (frame_rate * report_interval_s) == 0) {
             xil_printf("Frame: %lu\n\r", frame_counter);
-            xil_printf("Input time: %lu us\n\r",   profiler_breakout[1].elapsed_us);
-            xil_printf("Update time: %lu us\n\r",  profiler_breakout[2].elapsed_us);
-            xil_printf("Render time: %lu us\n\r",  profiler_breakout[3].elapsed_us);
-            xil_printf("Display time: %lu us\n\r", profiler_breakout[4].elapsed_us);
-            xil_printf("Total time: %lu us\n\r",
-                       profiler_breakout[1].elapsed_us +
-                       profiler_breakout[2].elapsed_us +
-                       profiler_breakout[3].elapsed_us +
-                       profiler_breakout[4].elapsed_us);
+            profiler_report_header();
+            profiler_report(profiler_breakout, 6);
+#if defined(PROFILE_PMU)
+            profiler_report_pmu_all();
+#endif
+#if defined(PROFILE_L2)
+            l2_counters_report();
+            l2_counters_reset();
+#endif
+#if defined(PROFILE_SAMPLES)
+            sampler_report_top(10);
+#endif
+#if defined(MEASURE_LATENCY)
+            latency_report();
+#endif
+            deadline_report();
+            buttons_report();
+            frameclock_report();
+            scheduler_report();
+            scheduler_reset_accounts();
+            arena_report();
+            footprint_check();
             xil_printf("\n\r");
         }
 
-        profiler_end(&profiler_breakout[0]);
-
-        // Frame rate capping
-        if (profiler_breakout[0].elapsed_us < FRAME_DELAY_US) {
-            usleep(FRAME_DELAY_US - profiler_breakout[0].elapsed_us);
+#if defined(AUTOPILOT)
+        // Soak: keep playing across wins and losses
+        if (!game.game_running) {
+            xil_printf("Autopilot restarting game after %lu frames\n\r", frame_counter);
+            init_game(&game);
         }
+#endif
+
+        // Frame rate capping: idle tasks and WFI until the frame's absolute deadline
+        profiler_start(&profiler_breakout[5]);
+        frameclock_wait();
+        profiler_end(&profiler_breakout[5]);
     }
 
     xil_printf("\n\rGame Over!\n\r");
     xil_printf("Final Score: %d\n\r", game.score);
     xil_printf("Lives Remaining: %d\n\r", game.lives);
+    deadline_report();
+    buttons_report();
+    buttons_stop();
+    footprint_report();
+
+#if defined(MEASURE_LATENCY)
+    latency_stop();
+    latency_report();
+#endif
+
+#if defined(PROFILE_SAMPLES)
+    sampler_stop();
+    xil_printf("Dumping %d PC samples:\n\r", sampler_total());
+    sampler_dump_uart();
+    xil_printf("\n\r");
+#endif
+
+#if defined(TRACE_FRAMES)
+    trace_stop();
+    xil_printf("Dumping trace (%d events):\n\r", trace_head);
+    trace_dump_uart();
+    xil_printf("\n\r");
+#endif
+
+#if defined(SNAPSHOT_RING)
+    xil_printf("Dumping the last %d frames' snapshots:\n\r", snapshot_ring_count());
+    snapshot_ring_dump_uart();
+    xil_printf("\n\r");
+#endif
+
+#if defined(RECORD_INPUT)
+    input_record_stop();
+    xil_printf("Dumping %d recorded frames:\n\r", input_record_frames());
+    input_record_dump_uart();
+    xil_printf("\n\r");
+#endif
+}
+
+// ============================================================================
+// HEADLESS SIMULATION BENCHMARK
+// ============================================================================
+static u32 headless_histogram[HEADLESS_BUCKETS];
+
+// Returns the upper edge (in ns) of the bucket that holds the given percentile
+static u32 headless_percentile_ns(u32 ticks, u32 percent) {
+    u32 target = (u32)(((u64)ticks * percent + 99) / 100);
+    u32 seen   = 0;
+
+    for (int i = 0; i < HEADLESS_BUCKETS; i++) {
+        seen += headless_histogram[i];
+        if (seen >= target)
+            return (i + 1) * HEADLESS_BUCKET_NS;
+    }
+    return HEADLESS_BUCKETS * HEADLESS_BUCKET_NS;
+}
+
+void breakout_game_run_headless(u32 ticks) {
+    GameState game;
+    XTime run_start, run_end, tick_start, tick_end;
+    XTime tick_min = ~(XTime)0;
+    XTime tick_max = 0;
+    u32   bucket_counts = (u32)((u64)HEADLESS_BUCKET_NS * COUNTS_PER_SECOND / 1000000000);
+    u32   games = 1;
+    u32   done;
+
+    if (bucket_counts == 0)
+        bucket_counts = 1;
+
+    // The push buttons need a person, replace them with a seeded random player
+    if (input_get_source() == INPUT_SOURCE_BUTTONS) {
+        input_set_random_seed(HEADLESS_SEED);
+        input_set_source(INPUT_SOURCE_RANDOM);
+    }
+
+    for (int i = 0; i < HEADLESS_BUCKETS; i++)
+        headless_histogram[i] = 0;
+
+    xil_printf("Headless benchmark: %d ticks, no rendering, no frame cap\n\r", ticks);
+
+    print_events = 0;
+    init_game(&game);
+    autopilot_attach(&game);
+
+    XTime_GetTime(&run_start);
+    for (done = 0; done < ticks; done++) {
+        XTime_GetTime(&tick_start);
+        handle_input_zynq(&game);
+        update_game(&game);
+        // Nothing renders here, so the frame arena is reset per tick instead
+        arena_reset(arena_frame());
+        XTime_GetTime(&tick_end);
+
+        XTime tick = tick_end - tick_start;
+        if (tick < tick_min) tick_min = tick;
+        if (tick > tick_max) tick_max = tick;
+        u32 bucket = (u32)(tick / bucket_counts);
+        if (bucket >= HEADLESS_BUCKETS)
+            bucket = HEADLESS_BUCKETS - 1;
+        headless_histogram[bucket]++;
+
+        if (!game.game_running) {
+            // A replayed trace cannot be restarted, everything else keeps playing
+            if (input_get_source() == INPUT_SOURCE_REPLAY && input_replay_done()) {
+                done++;
+                break;
+            }
+            init_game(&game);
+            games++;
+        }
+    }
+    XTime_GetTime(&run_end);
+    print_events = 1;
+
+    XTime run_counts = run_end - run_start;
+    if (run_counts == 0)
+        run_counts = 1;
+
+    xil_printf("Ticks: %d in %d games\n\r", done, games);
+    // Without a tick the min and the percentiles have nothing to report
+    if (done == 0)
+        return;
+    xil_printf("Run time: %d us\n\r",
+               (u32)(run_counts * 1000000 / COUNTS_PER_SECOND));
+    xil_printf("Ticks per second: %d\n\r",
+               (u32)((u64)done * COUNTS_PER_SECOND / run_counts));
+    xil_printf("Tick latency (ns): min %d | p50 %d | p90 %d | p99 %d | max %d\n\r",
+               (u32)(tick_min * 1000000000 / COUNTS_PER_SECOND),
+               headless_percentile_ns(done, 50),
+               headless_percentile_ns(done, 90),
+               headless_percentile_ns(done, 99),
+               (u32)(tick_max * 1000000000 / COUNTS_PER_SECOND));
+    if (headless_histogram[HEADLESS_BUCKETS - 1])
+        xil_printf("%d ticks took longer than the histogram range (%d ns)\n\r",
+                   headless_histogram[HEADLESS_BUCKETS - 1],
+                   (HEADLESS_BUCKETS - 1) * HEADLESS_BUCKET_NS);
 }
 
 // ============================================================================
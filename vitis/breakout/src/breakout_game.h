@@ -1,6 +1,100 @@
 #ifndef BREAKOUT_GAME_H
 #define BREAKOUT_GAME_H
 
+#include "xil_types.h"
+#include "fixed.h"
+
+/*
+ * Uncomment to run the game physics in Q16.16 fixed-point instead of float.
+ * The fixed-point path only uses integer math and table-driven trig, so the
+ * simulation is bit-identical between the board and a host build.
+ * Keep the switch here: fixed.c and snapshot.c test it too, and defining it
+ * in one .c file would give scalar_t a different layout in that file only.
+ */
+//#define BREAKOUT_FIXED_POINT
+
+// ============================================================================
+// CONSTANTS AND DEFINES
+// ============================================================================
+#define SCREEN_WIDTH  1920
+#define SCREEN_HEIGHT 1080
+
+// Game objects
+#define PADDLE_WIDTH   100
+#define PADDLE_HEIGHT  15
+#define PADDLE_SPEED   6
+#define PADDLE_Y       (SCREEN_HEIGHT - 40)
+
+#define BALL_RADIUS    7
+#define BALL_SPEED     6
+
+#define BRICK_WIDTH    75
+#define BRICK_HEIGHT   15
+#define BRICK_ROWS     4
+#define BRICK_COLS     10
+#define BRICK_PADDING  5
+
+#define MAX_LIVES      3
+
+#define WALL_WIDTH     480
+
+// ============================================================================
+// DATA STRUCTURES
+// ============================================================================
+#ifdef BREAKOUT_FIXED_POINT
+typedef fixed_t scalar_t;
+#define SCALAR(v)        FIXED_FROM_INT(v)
+#define SCALAR_TO_INT(v) FIXED_TO_INT(v)
+#else
+typedef float scalar_t;
+#define SCALAR(v)        ((float)(v))
+#define SCALAR_TO_INT(v) ((int)(v))
+#endif
+
+typedef struct {
+    scalar_t x;
+    scalar_t y;
+    scalar_t vx; // velocity x
+    scalar_t vy; // velocity y
+} Ball;
+
+typedef struct {
+    scalar_t x;
+    scalar_t y;
+    scalar_t vx;
+} Paddle;
+
+typedef struct {
+    scalar_t x;
+    scalar_t y;
+    int      alive;
+} Brick;
+
+typedef struct {
+    Ball   ball;
+    Paddle paddle;
+    Brick  bricks[BRICK_ROWS * BRICK_COLS];
+    int    score;
+    int    lives;
+    int    bricks_remaining;
+    int    game_running;
+    int    ball_launched;
+} GameState;
+
 void breakout_game_run();
+//starts a new game: full lives, every brick up, ball on the paddle
+void init_game(GameState *game);
+
+// Drawing primitives on top of renderer_draw_pixel, clipped to the screen
+void draw_rect(int x, int y, int w, int h, u8 r, u8 g, u8 b);
+void draw_filled_circle(int cx, int cy, int radius, u8 r, u8 g, u8 b);
+
+/*
+ * Runs only input and update_game as fast as possible for the given number of
+ * ticks (no rendering, no frame cap) and prints ticks per second and the
+ * per-tick latency distribution. Input comes from the selected input source;
+ * the push buttons are replaced with a seeded random player.
+ */
+void breakout_game_run_headless(u32 ticks);
 
 #endif //BREAKOUT_GAME_H
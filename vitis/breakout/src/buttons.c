@@ -0,0 +1,209 @@
+#include "buttons.h"
+
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xil_printf.h"
+#include "xpseudo_asm.h"
+#include "xstatus.h"
+#include "input.h"
+#include "interrupts.h"
+#include "profiler.h"
+
+//global timer registers and control bits not covered by xtime_l.h
+#define BUTTONS_GTIMER_ISR_OFFSET            0x0C
+#define BUTTONS_GTIMER_COMPARATOR_LOWER      0x10
+#define BUTTONS_GTIMER_COMPARATOR_UPPER      0x14
+#define BUTTONS_GTIMER_AUTO_INCREMENT        0x18
+#define BUTTONS_GTIMER_TIMER_ENABLE          0x1
+#define BUTTONS_GTIMER_COMP_ENABLE           0x2
+#define BUTTONS_GTIMER_IRQ_ENABLE            0x4
+#define BUTTONS_GTIMER_AUTO_INCREMENT_ENABLE 0x8
+#define BUTTONS_GTIMER_EVENT                 0x1
+
+#define BUTTONS_COUNT 4
+#define BUTTONS_DEBOUNCE_COUNTS ((XTime)COUNTS_PER_SECOND * BUTTONS_DEBOUNCE_US / 1000000)
+
+static int buttons_ready;
+
+/*
+ * Single producer (the ISR) single consumer (the game loop) ring: only the
+ * ISR writes queue_head and only the consumer writes queue_tail, so neither
+ * side has to mask interrupts.
+ */
+static buttons_event_s buttons_queue[BUTTONS_QUEUE_SIZE];
+static volatile u32 queue_head;
+static volatile u32 queue_tail;
+static volatile u32 queue_dropped;
+
+static volatile u8 buttons_stable; //debounced state, owned by the ISR
+static XTime buttons_last_edge[BUTTONS_COUNT];
+
+//oldest press drained by the last buttons_read()
+static XTime read_press_time;
+static int read_pressed;
+
+//press to buttons_read() latency since the previous report
+static u32 latency_presses;
+static u32 latency_sum_us;
+static u32 latency_max_us;
+
+static void buttons_interrupt(void *ref){
+	buttons_event_s *event;
+	XTime now;
+	u8 raw, changed, accepted;
+	int i;
+
+	Xil_Out32(GLOBAL_TMR_BASEADDR + BUTTONS_GTIMER_ISR_OFFSET, BUTTONS_GTIMER_EVENT);
+
+	raw = Xil_In32(INPUT_BTN_BASEADDR) & INPUT_BTN_MASK;
+	changed = raw ^ buttons_stable;
+	if (!changed)
+		return;
+
+	XTime_GetTime(&now);
+	accepted = 0;
+	for (i = 0; i < BUTTONS_COUNT; i++){
+		if (!(changed & (1 << i)))
+			continue;
+		//the first edge goes through at once, the bounces after it are ignored
+		if (now - buttons_last_edge[i] >= BUTTONS_DEBOUNCE_COUNTS){
+			buttons_last_edge[i] = now;
+			accepted |= 1 << i;
+		}
+	}
+	if (!accepted)
+		return;
+
+	buttons_stable ^= accepted;
+
+	if (queue_head - queue_tail == BUTTONS_QUEUE_SIZE){
+		queue_dropped++;
+		return;
+	}
+	event = &buttons_queue[queue_head & (BUTTONS_QUEUE_SIZE - 1)];
+	event->time = now;
+	event->buttons = buttons_stable;
+	event->pressed = accepted & buttons_stable;
+	event->released = accepted & ~buttons_stable;
+	event->reserved = 0;
+	//the event must be complete before the consumer can see it
+	dmb();
+	queue_head++;
+}
+
+int buttons_initialize(){
+	XTime now, next;
+	u32 period = COUNTS_PER_SECOND / BUTTONS_POLL_HZ;
+	u32 control;
+	int i;
+
+	if (buttons_ready)
+		return XST_SUCCESS;
+
+	queue_head = 0;
+	queue_tail = 0;
+	queue_dropped = 0;
+	buttons_stable = Xil_In32(INPUT_BTN_BASEADDR) & INPUT_BTN_MASK;
+	for (i = 0; i < BUTTONS_COUNT; i++)
+		buttons_last_edge[i] = 0;
+
+	//the comparator has to be disabled while it is changed, the counter keeps running for XTime
+	control = Xil_In32(GLOBAL_TMR_BASEADDR + GTIMER_CONTROL_OFFSET);
+	control &= ~(BUTTONS_GTIMER_COMP_ENABLE | BUTTONS_GTIMER_IRQ_ENABLE | BUTTONS_GTIMER_AUTO_INCREMENT_ENABLE);
+	Xil_Out32(GLOBAL_TMR_BASEADDR + GTIMER_CONTROL_OFFSET, control);
+
+	XTime_GetTime(&now);
+	next = now + period;
+	Xil_Out32(GLOBAL_TMR_BASEADDR + BUTTONS_GTIMER_COMPARATOR_LOWER, (u32)next);
+	Xil_Out32(GLOBAL_TMR_BASEADDR + BUTTONS_GTIMER_COMPARATOR_UPPER, (u32)(next >> 32));
+	Xil_Out32(GLOBAL_TMR_BASEADDR + BUTTONS_GTIMER_AUTO_INCREMENT, period);
+	Xil_Out32(GLOBAL_TMR_BASEADDR + BUTTONS_GTIMER_ISR_OFFSET, BUTTONS_GTIMER_EVENT);
+
+	if (interrupts_connect(XPAR_GLOBAL_TMR_INTR, buttons_interrupt, NULL, INTERRUPTS_PRIORITY_HIGH) != XST_SUCCESS)
+		return XST_FAILURE;
+
+	Xil_Out32(GLOBAL_TMR_BASEADDR + GTIMER_CONTROL_OFFSET, control | BUTTONS_GTIMER_TIMER_ENABLE |
+			BUTTONS_GTIMER_COMP_ENABLE | BUTTONS_GTIMER_IRQ_ENABLE | BUTTONS_GTIMER_AUTO_INCREMENT_ENABLE);
+
+	buttons_ready = TRUE;
+	return XST_SUCCESS;
+}
+
+void buttons_stop(){
+	u32 control;
+
+	if (!buttons_ready)
+		return;
+
+	control = Xil_In32(GLOBAL_TMR_BASEADDR + GTIMER_CONTROL_OFFSET);
+	control &= ~(BUTTONS_GTIMER_COMP_ENABLE | BUTTONS_GTIMER_IRQ_ENABLE | BUTTONS_GTIMER_AUTO_INCREMENT_ENABLE);
+	Xil_Out32(GLOBAL_TMR_BASEADDR + GTIMER_CONTROL_OFFSET, control);
+	interrupts_disconnect(XPAR_GLOBAL_TMR_INTR);
+	buttons_ready = FALSE;
+}
+
+int buttons_pop(buttons_event_s *event){
+	if (queue_tail == queue_head)
+		return FALSE;
+
+	dmb();
+	*event = buttons_queue[queue_tail & (BUTTONS_QUEUE_SIZE - 1)];
+	//the slot must be read before the ISR can reuse it
+	dmb();
+	queue_tail++;
+	return TRUE;
+}
+
+u32 buttons_read(){
+	buttons_event_s event;
+	XTime now;
+	u32 pressed = 0;
+	u32 latency_us;
+
+	if (!buttons_ready)
+		return Xil_In32(INPUT_BTN_BASEADDR) & INPUT_BTN_MASK;
+
+	XTime_GetTime(&now);
+	read_pressed = FALSE;
+	while (buttons_pop(&event)){
+		if (!event.pressed)
+			continue;
+		pressed |= event.pressed;
+		if (!read_pressed){
+			read_press_time = event.time;
+			read_pressed = TRUE;
+		}
+
+		latency_us = (u32)(((now - event.time) * PROFILER_US_PER_COUNT_Q32) >> 32);
+		latency_presses++;
+		latency_sum_us += latency_us;
+		if (latency_us > latency_max_us)
+			latency_max_us = latency_us;
+	}
+
+	return buttons_stable | pressed;
+}
+
+int buttons_press_time(XTime *time){
+	if (!read_pressed)
+		return FALSE;
+	*time = read_press_time;
+	return TRUE;
+}
+
+u32 buttons_dropped(){
+	return queue_dropped;
+}
+
+void buttons_print(){
+	xil_printf("buttons: %d presses, latency mean %d us max %d us, %d dropped\n\r",
+			latency_presses, latency_presses ? latency_sum_us / latency_presses : 0,
+			latency_max_us, queue_dropped);
+}
+
+void buttons_report(){
+	buttons_print();
+	latency_presses = 0;
+	latency_sum_us = 0;
+	latency_max_us = 0;
+}
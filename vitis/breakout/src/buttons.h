@@ -0,0 +1,56 @@
+#ifndef BUTTONS_H
+#define BUTTONS_H
+
+#include "xil_types.h"
+#include "xtime_l.h"
+
+/*
+ * Interrupt-driven push buttons: the global timer comparator interrupts at
+ * BUTTONS_POLL_HZ and the ISR samples the button GPIO, debounces it and
+ * pushes every accepted edge with its XTime timestamp into a lock-free queue.
+ * The game drains the queue once per frame in buttons_read(), so a press is
+ * seen within 1/BUTTONS_POLL_HZ instead of up to a frame later, and a press
+ * shorter than a frame still reaches the game.
+ *
+ * The button GPIO (axi_gpio_0) is not in the exported platform, so there is
+ * no GPIO interrupt to latch the edges with and they are sampled instead.
+ */
+
+#define BUTTONS_POLL_HZ     2000
+//an edge is accepted, then the button ignores bounces for this long
+#define BUTTONS_DEBOUNCE_US 5000
+//must be a power of two
+#define BUTTONS_QUEUE_SIZE  64
+
+typedef struct {
+	XTime time;  //when the ISR saw the edge
+	u8 buttons;  //debounced state after the edge
+	u8 pressed;  //buttons that went down
+	u8 released; //buttons that went up
+	u8 reserved;
+} buttons_event_s;
+
+//starts the sampling interrupt, buttons_read() reads the GPIO directly until then
+int buttons_initialize();
+void buttons_stop();
+
+/*
+ * Drains the queue and returns the button state for this frame: the
+ * debounced state, plus every button pressed since the previous call even if
+ * it has been released again. Call once per frame.
+ */
+u32 buttons_read();
+//pops the oldest queued edge, FALSE if there is none
+int buttons_pop(buttons_event_s *event);
+
+//time of the oldest press the last buttons_read() drained, FALSE if it drained none
+int buttons_press_time(XTime *time);
+
+//edges dropped because the queue was full
+u32 buttons_dropped();
+//prints the edge count and the press to buttons_read() latency since the previous report
+void buttons_print();
+//buttons_print, then starts a new report interval
+void buttons_report();
+
+#endif //BUTTONS_H
@@ -0,0 +1,217 @@
+#include "cache_profile.h"
+
+#include <string.h>
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xil_cache_l.h"
+#include "xil_exception.h"
+#include "xil_printf.h"
+#include "xl2cc.h"
+#include "xparameters_ps.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+
+#include "renderer.h"
+#include "display_ctrl/display_ctrl.h"
+
+//PL310 prefetch control, not in xl2cc.h
+#define CACHE_PROFILE_L2_PREFETCH_OFFSET 0x0F60U
+#define L2_PREFETCH_DOUBLE_LINEFILL      0x40000000U
+#define L2_PREFETCH_INSTRUCTION          0x20000000U
+#define L2_PREFETCH_DATA                 0x10000000U
+#define L2_PREFETCH_NO_WRAP_LINEFILL     0x08000000U //no double linefill on WRAP reads
+#define L2_PREFETCH_DROP                 0x01000000U
+#define L2_PREFETCH_INCR_LINEFILL        0x00800000U
+#define L2_PREFETCH_OFFSET_MASK          0x0000001FU
+
+//Cortex-A9 auxiliary control
+#define ACTLR_FULL_LINE_OF_ZEROS 0x00000008U
+#define ACTLR_L1_PREFETCH        0x00000004U
+#define ACTLR_L2_PREFETCH_HINT   0x00000002U
+
+//the bits a profile owns, everything else is left as boot.S set it
+#define CACHE_PROFILE_AUX_MASK (XPS_L2CC_AUX_EBRESPE_MASK | XPS_L2CC_AUX_IPFE_MASK | \
+		XPS_L2CC_AUX_DPFE_MASK | XPS_L2CC_AUX_FLZE_MASK)
+#define CACHE_PROFILE_ACTLR_MASK (ACTLR_FULL_LINE_OF_ZEROS | ACTLR_L1_PREFETCH | ACTLR_L2_PREFETCH_HINT)
+
+#define L2_READ(offset)         Xil_In32(XPS_L2CC_BASEADDR + (offset))
+#define L2_WRITE(offset, value) Xil_Out32(XPS_L2CC_BASEADDR + (offset), (value))
+
+typedef struct {
+	const char *name;
+	u32 l2_aux;       //PL310 auxiliary control bits under CACHE_PROFILE_AUX_MASK
+	u32 l2_prefetch;  //PL310 prefetch control
+	u32 actlr;        //ACTLR bits under CACHE_PROFILE_ACTLR_MASK
+} cache_profile_s;
+
+/*
+ * The boot entry is read back from the hardware before the first change.
+ * Double linefill is safe on the r3p2 PL310 in the Zynq, erratum 752271 is
+ * fixed there. A prefetch offset of 7 lines keeps ahead of a sequential stream
+ * without running far past the end of a frame.
+ */
+static cache_profile_s cache_profiles[CACHE_PROFILES] = {
+	{"boot", 0, 0, 0},
+	{"minimal", 0, 0, 0},
+	{"streaming",
+		XPS_L2CC_AUX_EBRESPE_MASK | XPS_L2CC_AUX_IPFE_MASK | XPS_L2CC_AUX_DPFE_MASK |
+		XPS_L2CC_AUX_FLZE_MASK,
+		L2_PREFETCH_DOUBLE_LINEFILL | L2_PREFETCH_INSTRUCTION | L2_PREFETCH_DATA |
+		L2_PREFETCH_NO_WRAP_LINEFILL | L2_PREFETCH_DROP | L2_PREFETCH_INCR_LINEFILL | 7,
+		ACTLR_FULL_LINE_OF_ZEROS | ACTLR_L1_PREFETCH | ACTLR_L2_PREFETCH_HINT}
+};
+
+static int cache_profile_captured;
+static cache_profile_e cache_profile_active = CACHE_PROFILE_BOOT;
+
+static void cache_profile_capture(){
+	if (cache_profile_captured)
+		return;
+	cache_profiles[CACHE_PROFILE_BOOT].l2_aux = L2_READ(XPS_L2CC_AUX_CNTRL_OFFSET) & CACHE_PROFILE_AUX_MASK;
+	cache_profiles[CACHE_PROFILE_BOOT].l2_prefetch = L2_READ(CACHE_PROFILE_L2_PREFETCH_OFFSET);
+	cache_profiles[CACHE_PROFILE_BOOT].actlr = mfcp(XREG_CP15_AUX_CONTROL) & CACHE_PROFILE_ACTLR_MASK;
+	cache_profile_captured = TRUE;
+}
+
+int cache_profile_apply(cache_profile_e profile){
+	const cache_profile_s *p;
+	u32 cpsr;
+	u32 actlr;
+	u32 aux;
+	int l2_on;
+
+	if (profile >= CACHE_PROFILES)
+		return XST_FAILURE;
+	cache_profile_capture();
+	p = &cache_profiles[profile];
+
+	cpsr = mfcpsr();
+	mtcpsr(cpsr | XIL_EXCEPTION_ALL);
+
+	//the core must stop sending full line of zeros writes before the L2 stops expecting them
+	actlr = mfcp(XREG_CP15_AUX_CONTROL);
+	mtcp(XREG_CP15_AUX_CONTROL, actlr & ~CACHE_PROFILE_ACTLR_MASK);
+	isb();
+
+	//the auxiliary control can only be written with the L2 off, which needs it clean first
+	l2_on = L2_READ(XPS_L2CC_CNTRL_OFFSET) & XPS_L2CC_ENABLE_MASK;
+	Xil_DCacheFlush();
+	Xil_L2CacheDisable();
+
+	aux = L2_READ(XPS_L2CC_AUX_CNTRL_OFFSET);
+	L2_WRITE(XPS_L2CC_AUX_CNTRL_OFFSET, (aux & ~CACHE_PROFILE_AUX_MASK) | p->l2_aux);
+	L2_WRITE(CACHE_PROFILE_L2_PREFETCH_OFFSET, p->l2_prefetch);
+
+	//not Xil_L2CacheEnable(), it would put its own auxiliary control defaults back
+	if (l2_on){
+		L2_WRITE(XPS_L2CC_CNTRL_OFFSET, XPS_L2CC_ENABLE_MASK);
+		L2_WRITE(XPS_L2CC_CACHE_SYNC_OFFSET, 0);
+		dsb();
+	}
+
+	mtcp(XREG_CP15_AUX_CONTROL, (actlr & ~CACHE_PROFILE_ACTLR_MASK) | p->actlr);
+	isb();
+
+	mtcpsr(cpsr);
+	cache_profile_active = profile;
+	return XST_SUCCESS;
+}
+
+cache_profile_e cache_profile_get(){
+	return cache_profile_active;
+}
+
+void cache_profile_report(){
+	cache_profile_capture();
+	xil_printf("cache profile %s: l2 aux 0x%08x prefetch 0x%08x, actlr 0x%08x\n\r",
+			cache_profiles[cache_profile_active].name,
+			L2_READ(XPS_L2CC_AUX_CNTRL_OFFSET),
+			L2_READ(CACHE_PROFILE_L2_PREFETCH_OFFSET),
+			mfcp(XREG_CP15_AUX_CONTROL));
+}
+
+//MB/s of the best pass, bytes per us is MB per second
+static u32 cache_profile_mbps(XTime best){
+	u32 us = (u32)(best * 1000000 / COUNTS_PER_SECOND);
+
+	return us ? RENDERER_MAX_FRAME / us : 0;
+}
+
+void cache_profile_bench(u32 iterations){
+	static const cache_profile_e order[CACHE_PROFILES] = {
+		CACHE_PROFILE_MINIMAL, CACHE_PROFILE_BOOT, CACHE_PROFILE_STREAMING
+	};
+	cache_profile_e restore = cache_profile_active;
+	XTime best_fill, best_zero, best_copy, best_read;
+	XTime start;
+	XTime end;
+	volatile u32 sink;
+	u32 sum;
+	u32 *word;
+	u8 *frame;
+	u8 *other;
+	u32 i, n;
+
+	if (iterations == 0)
+		iterations = CACHE_PROFILE_BENCH_DEFAULT_ITERATIONS;
+
+	//two back buffers, neither is the one being scanned out
+	frame = renderer_get_frame_buffer(renderer_get_frame_index());
+	other = renderer_get_frame_buffer(renderer_get_frame_index() + 1 < DISPLAY_NUM_FRAMES ?
+			renderer_get_frame_index() + 1 : 1);
+
+	xil_printf("Cache profile benchmark, best of %d passes, %d KB per pass\n\r",
+			iterations, RENDERER_MAX_FRAME / 1024);
+	xil_printf("profile     fill MB/s  zero MB/s  copy MB/s  read MB/s\n\r");
+
+	for (n = 0; n < CACHE_PROFILES; n++){
+		cache_profile_apply(order[n]);
+		best_fill = best_zero = best_copy = best_read = ~0ULL;
+
+		for (i = 0; i < iterations; i++){
+			//fill, the same work as the clear and flush of a frame
+			XTime_GetTime(&start);
+			memset(frame, 0x40 + i, RENDERER_MAX_FRAME);
+			Xil_DCacheFlushRange((INTPTR)frame, RENDERER_MAX_FRAME);
+			XTime_GetTime(&end);
+			if (end - start < best_fill)
+				best_fill = end - start;
+
+			//a black clear, where full line of zeros applies
+			XTime_GetTime(&start);
+			memset(frame, 0, RENDERER_MAX_FRAME);
+			Xil_DCacheFlushRange((INTPTR)frame, RENDERER_MAX_FRAME);
+			XTime_GetTime(&end);
+			if (end - start < best_zero)
+				best_zero = end - start;
+
+			XTime_GetTime(&start);
+			memcpy(other, frame, RENDERER_MAX_FRAME);
+			Xil_DCacheFlushRange((INTPTR)other, RENDERER_MAX_FRAME);
+			XTime_GetTime(&end);
+			if (end - start < best_copy)
+				best_copy = end - start;
+
+			//sequential reads of a frame that is not in the caches, where prefetch applies
+			Xil_DCacheInvalidateRange((INTPTR)other, RENDERER_MAX_FRAME);
+			sum = 0;
+			XTime_GetTime(&start);
+			for (word = (u32 *)other; word < (u32 *)(other + RENDERER_MAX_FRAME); word++)
+				sum += *word;
+			XTime_GetTime(&end);
+			sink = sum;
+			if (end - start < best_read)
+				best_read = end - start;
+		}
+
+		xil_printf("%-10s %10d %10d %10d %10d\n\r", cache_profiles[order[n]].name,
+				cache_profile_mbps(best_fill), cache_profile_mbps(best_zero),
+				cache_profile_mbps(best_copy), cache_profile_mbps(best_read));
+	}
+	(void)sink;
+
+	cache_profile_apply(restore);
+	cache_profile_report();
+}
@@ -0,0 +1,44 @@
+#ifndef CACHE_PROFILE_H
+#define CACHE_PROFILE_H
+
+#include "xil_types.h"
+
+/*
+ * Cache and prefetch profiles: sets of the PL310 L2 cache controller and
+ * Cortex-A9 auxiliary control features that decide how well streaming frame
+ * buffer work uses DDR. init_platform() applies CACHE_PROFILE_DEFAULT.
+ *
+ *   L2 data/instruction prefetch (PL310 auxiliary and prefetch control)
+ *   L2 double linefill and prefetch offset (PL310 prefetch control)
+ *   Early BRESP, the L2 acknowledges writes before DDR does (PL310 auxiliary control)
+ *   Full line of zeros, a write of a whole line of zeros is not read first (PL310 and ACTLR)
+ *   L1 data prefetch and L2 prefetch hints (ACTLR)
+ *
+ * cache_profile_bench() measures frame fill, copy and read bandwidth under
+ * every profile, so the choice can be checked on the board.
+ */
+
+typedef enum {
+	CACHE_PROFILE_BOOT = 0,   //as boot.S and Xil_L2CacheEnable() left it
+	CACHE_PROFILE_MINIMAL,    //every prefetch and write feature off, the baseline
+	CACHE_PROFILE_STREAMING,  //tuned for full frame sequential clears, copies and flushes
+	CACHE_PROFILES
+} cache_profile_e;
+
+#define CACHE_PROFILE_DEFAULT CACHE_PROFILE_STREAMING
+#define CACHE_PROFILE_BENCH_DEFAULT_ITERATIONS 10
+
+//must be called with no DMA into cacheable memory running, the L2 is flushed and briefly disabled
+int cache_profile_apply(cache_profile_e profile);
+cache_profile_e cache_profile_get();
+//prints the active profile and the registers it set
+void cache_profile_report();
+
+/*
+ * Best of iterations passes of a frame fill, copy and read under each profile,
+ * on the back buffers. Call it after renderer_initialize and before the game
+ * takes over the frame buffers. The active profile is restored afterwards.
+ */
+void cache_profile_bench(u32 iterations);
+
+#endif //CACHE_PROFILE_H
@@ -0,0 +1,341 @@
+#include "console.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include "xparameters.h"
+#include "xuartps_hw.h"
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "scheduler.h"
+
+//bytes taken from the receive FIFO per slice, well under CONSOLE_SLICE_US at 115200 baud
+#define CONSOLE_BYTES_PER_POLL 16
+//bytes moved to the transmit FIFO per slice, each is one register write
+#define CONSOLE_BYTES_PER_DRAIN 32
+#define CONSOLE_TRUNCATED      "[output truncated]\n\r"
+#define CONSOLE_MAX_ARGS       3
+#define CONSOLE_PROMPT         "> "
+
+typedef struct {
+	const char *name;
+	const char *help;
+	s32 *value;
+	s32 min;
+	s32 max;
+	console_apply_fn apply;
+} console_tunable_s;
+
+typedef struct {
+	const char *name;
+	console_stats_fn report;
+} console_stats_s;
+
+static scheduler_task_s console_task;
+static scheduler_task_s console_report_task;
+static int console_ready;
+static console_tunable_s console_tunables[CONSOLE_MAX_TUNABLES];
+static int console_tunable_count;
+static console_stats_s console_stats[CONSOLE_MAX_STATS];
+static int console_stats_count;
+
+static char console_line[CONSOLE_LINE_BYTES];
+static u32 console_line_length;
+static int console_line_overflow;
+
+/*
+ * Console output waiting for the transmit FIFO. Commands and reports only run
+ * when it is empty, so it is filled from the start and drained in order.
+ * There is room past CONSOLE_OUT_BYTES for the truncation note.
+ */
+static char console_out[CONSOLE_OUT_BYTES + sizeof(CONSOLE_TRUNCATED)];
+static u32 console_out_head; //next byte to send
+static u32 console_out_tail; //end of the buffered output
+static int console_out_dropped;
+static int console_capturing;
+
+//reports still to run from a stats command, one per slice so the others get time in between
+static int console_stats_next;
+static int console_stats_end;
+
+void __real_outbyte(char c);
+
+//every outbyte goes through here (linked with -Wl,--wrap=outbyte), so xil_printf can be captured
+void __wrap_outbyte(char c){
+	if (!console_capturing){
+		__real_outbyte(c);
+		return;
+	}
+	if (console_out_tail == CONSOLE_OUT_BYTES){
+		console_out_dropped = TRUE;
+		return;
+	}
+	console_out[console_out_tail++] = c;
+}
+
+static void console_capture_start(){
+	console_out_dropped = FALSE;
+	console_capturing = TRUE;
+}
+
+static void console_capture_end(){
+	console_capturing = FALSE;
+	if (console_out_dropped){
+		memcpy(&console_out[console_out_tail], CONSOLE_TRUNCATED, sizeof(CONSOLE_TRUNCATED) - 1);
+		console_out_tail += sizeof(CONSOLE_TRUNCATED) - 1;
+	}
+}
+
+//moves buffered output into the transmit FIFO without waiting on it, returns TRUE if any moved
+static int console_drain(){
+	int sent = 0;
+
+	while (console_out_head < console_out_tail && sent < CONSOLE_BYTES_PER_DRAIN &&
+			!XUartPs_IsTransmitFull(STDOUT_BASEADDRESS)){
+		XUartPs_WriteReg(STDOUT_BASEADDRESS, XUARTPS_FIFO_OFFSET, console_out[console_out_head++]);
+		sent++;
+	}
+	if (console_out_head == console_out_tail){
+		console_out_head = 0;
+		console_out_tail = 0;
+	}
+	return sent > 0;
+}
+
+int console_add_tunable(const char *name, const char *help, s32 *value, s32 min, s32 max,
+		console_apply_fn apply){
+	console_tunable_s *tunable;
+
+	if (console_tunable_count == CONSOLE_MAX_TUNABLES || min > max)
+		return XST_FAILURE;
+
+	tunable = &console_tunables[console_tunable_count++];
+	tunable->name = name;
+	tunable->help = help;
+	tunable->value = value;
+	tunable->min = min;
+	tunable->max = max;
+	tunable->apply = apply;
+	return XST_SUCCESS;
+}
+
+int console_add_stats(const char *name, console_stats_fn report){
+	if (console_stats_count == CONSOLE_MAX_STATS)
+		return XST_FAILURE;
+
+	console_stats[console_stats_count].name = name;
+	console_stats[console_stats_count].report = report;
+	console_stats_count++;
+	return XST_SUCCESS;
+}
+
+static console_tunable_s *console_find_tunable(const char *name){
+	int i;
+
+	for (i = 0; i < console_tunable_count; i++){
+		if (strcmp(console_tunables[i].name, name) == 0)
+			return &console_tunables[i];
+	}
+	return NULL;
+}
+
+static void console_print_tunable(const console_tunable_s *tunable){
+	xil_printf("  %-12s %8d  [%d, %d]  %s\n\r", tunable->name, *tunable->value,
+			tunable->min, tunable->max, tunable->help);
+}
+
+static void console_help(){
+	int i;
+
+	xil_printf("commands: help, get [name], set name value, stats [name]\n\r");
+	xil_printf("tunables:\n\r");
+	for (i = 0; i < console_tunable_count; i++)
+		console_print_tunable(&console_tunables[i]);
+	xil_printf("stats:");
+	for (i = 0; i < console_stats_count; i++)
+		xil_printf(" %s", console_stats[i].name);
+	xil_printf("\n\r");
+}
+
+static void console_get(int argc, char **argv){
+	console_tunable_s *tunable;
+	int i;
+
+	if (argc < 2){
+		for (i = 0; i < console_tunable_count; i++)
+			console_print_tunable(&console_tunables[i]);
+		return;
+	}
+	tunable = console_find_tunable(argv[1]);
+	if (tunable == NULL){
+		xil_printf("no tunable %s\n\r", argv[1]);
+		return;
+	}
+	console_print_tunable(tunable);
+}
+
+static void console_set(int argc, char **argv){
+	console_tunable_s *tunable;
+	char *end;
+	long value;
+
+	if (argc < 3){
+		xil_printf("usage: set name value\n\r");
+		return;
+	}
+	tunable = console_find_tunable(argv[1]);
+	if (tunable == NULL){
+		xil_printf("no tunable %s\n\r", argv[1]);
+		return;
+	}
+	value = strtol(argv[2], &end, 0);
+	if (*end != '\0' || value < tunable->min || value > tunable->max){
+		xil_printf("%s must be a number in [%d, %d]\n\r", tunable->name, tunable->min, tunable->max);
+		return;
+	}
+
+	*tunable->value = (s32)value;
+	if (tunable->apply != NULL)
+		tunable->apply(*tunable->value);
+	console_print_tunable(tunable);
+}
+
+static void console_stats_command(int argc, char **argv){
+	int i;
+
+	if (argc < 2){
+		console_stats_next = 0;
+		console_stats_end = console_stats_count;
+		return;
+	}
+	for (i = 0; i < console_stats_count; i++){
+		if (strcmp(console_stats[i].name, argv[1]) == 0){
+			console_stats_next = i;
+			console_stats_end = i + 1;
+			return;
+		}
+	}
+	xil_printf("no stats %s\n\r", argv[1]);
+}
+
+static void console_execute(char *line){
+	char *argv[CONSOLE_MAX_ARGS];
+	int argc = 0;
+
+	//split on spaces, extra words are ignored
+	while (*line != '\0' && argc < CONSOLE_MAX_ARGS){
+		while (*line == ' ')
+			*line++ = '\0';
+		if (*line == '\0')
+			break;
+		argv[argc++] = line;
+		while (*line != '\0' && *line != ' ')
+			line++;
+	}
+	if (argc == 0)
+		return;
+
+	if (strcmp(argv[0], "help") == 0)
+		console_help();
+	else if (strcmp(argv[0], "get") == 0)
+		console_get(argc, argv);
+	else if (strcmp(argv[0], "set") == 0)
+		console_set(argc, argv);
+	else if (strcmp(argv[0], "stats") == 0)
+		console_stats_command(argc, argv);
+	else
+		xil_printf("unknown command %s, try help\n\r", argv[0]);
+}
+
+//takes one byte of input, runs the line on return and then returns TRUE
+static int console_receive(char c){
+	if (c == '\r' || c == '\n'){
+		xil_printf("\n\r");
+		console_line[console_line_length] = '\0';
+		if (console_line_overflow)
+			xil_printf("line longer than %d bytes ignored\n\r", CONSOLE_LINE_BYTES - 1);
+		else
+			console_execute(console_line);
+		console_line_length = 0;
+		console_line_overflow = FALSE;
+		//a stats command prints the prompt once its reports are done
+		if (console_stats_next == console_stats_end)
+			xil_printf(CONSOLE_PROMPT);
+		return TRUE;
+	}
+	if (c == '\b' || c == 0x7F){
+		if (console_line_length > 0){
+			console_line_length--;
+			xil_printf("\b \b");
+		}
+		return FALSE;
+	}
+	if (c < ' ')
+		return FALSE;
+
+	if (console_line_length == CONSOLE_LINE_BYTES - 1){
+		console_line_overflow = TRUE;
+		return FALSE;
+	}
+	console_line[console_line_length++] = c;
+	outbyte(c);
+	return FALSE;
+}
+
+static int console_poll(void *ref){
+	int did_work;
+	int i;
+
+	//earlier output goes out first, nothing new is printed until it has
+	did_work = console_drain();
+	if (console_out_tail != 0)
+		return did_work;
+
+	//input waits while console_report runs a stats command
+	if (console_stats_next < console_stats_end)
+		return did_work;
+
+	console_capture_start();
+	//at most one line per slice, the rest stays in the FIFO
+	for (i = 0; i < CONSOLE_BYTES_PER_POLL && XUartPs_IsReceiveData(STDIN_BASEADDRESS); i++){
+		did_work = TRUE;
+		if (console_receive((char)XUartPs_ReadReg(STDIN_BASEADDRESS, XUARTPS_FIFO_OFFSET)))
+			break;
+	}
+	console_capture_end();
+
+	console_drain();
+	return did_work;
+}
+
+//runs one report of a pending stats command, in its own task so its longer slice is declared
+static int console_report(void *ref){
+	if (console_stats_next == console_stats_end || console_out_tail != 0)
+		return FALSE;
+
+	console_capture_start();
+	xil_printf("-- %s --\n\r", console_stats[console_stats_next].name);
+	console_stats[console_stats_next++].report();
+	if (console_stats_next == console_stats_end)
+		xil_printf(CONSOLE_PROMPT);
+	console_capture_end();
+
+	console_drain();
+	return TRUE;
+}
+
+int console_initialize(){
+	if (console_ready)
+		return XST_SUCCESS;
+	if (scheduler_add(&console_task, "console", console_poll, NULL,
+			SCHEDULER_PRIORITY_LOW, CONSOLE_SLICE_US) != XST_SUCCESS)
+		return XST_FAILURE;
+	if (scheduler_add(&console_report_task, "console stats", console_report, NULL,
+			SCHEDULER_PRIORITY_LOW, CONSOLE_REPORT_SLICE_US) != XST_SUCCESS){
+		scheduler_remove(&console_task);
+		return XST_FAILURE;
+	}
+
+	console_ready = TRUE;
+	xil_printf("Console ready, type help\n\r" CONSOLE_PROMPT);
+	return XST_SUCCESS;
+}
@@ -0,0 +1,51 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "xil_types.h"
+
+/*
+ * Tuning console on the stdout UART. The receive FIFO is polled by a low
+ * priority scheduler task (see scheduler.h), so typing never blocks the frame
+ * loop. Lines are echoed back and run on return:
+ *
+ *   help              lists the commands and the tunables
+ *   get [name]        prints one tunable, or all of them
+ *   set name value    changes a tunable, decimal or 0x hex, within its range
+ *   stats [name]      runs one registered report, or all of them
+ *
+ * Tunables are s32 variables owned by other modules, registered with a range
+ * and an optional function that applies a new value. Everything the console
+ * prints, the stats reports included, is captured into a buffer instead of
+ * waiting on the UART, and drained into the transmit FIFO a few bytes per
+ * slice. The capture relies on linking with -Wl,--wrap=outbyte.
+ */
+
+#define CONSOLE_MAX_TUNABLES 16
+#define CONSOLE_MAX_STATS    16
+#define CONSOLE_LINE_BYTES   64
+//output of one command or report, anything past it is dropped
+#define CONSOLE_OUT_BYTES    4096
+//declared slice of the polling task, which reads input, runs commands and drains output
+#define CONSOLE_SLICE_US     100
+/*
+ * Declared slice of the task that runs one stats report. A report is not
+ * split, so this covers the longest one (footprint scans the painted stacks,
+ * profiler walks every zone's histogram); the scheduler account of the
+ * "console stats" task shows the real max_us.
+ */
+#define CONSOLE_REPORT_SLICE_US 2000
+
+//called after the value changed, with the new value already stored
+typedef void (*console_apply_fn)(s32 value);
+typedef void (*console_stats_fn)();
+
+//registers the polling and report tasks with the scheduler
+int console_initialize();
+
+//value must stay valid while the console runs
+int console_add_tunable(const char *name, const char *help, s32 *value, s32 min, s32 max,
+		console_apply_fn apply);
+//report must only print, a reset would take data from the periodic report
+int console_add_stats(const char *name, console_stats_fn report);
+
+#endif //CONSOLE_H
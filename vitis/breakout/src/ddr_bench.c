@@ -0,0 +1,147 @@
+#include "ddr_bench.h"
+
+#include <string.h>
+#include "xil_cache.h"
+#include "xil_printf.h"
+#include "xtime_l.h"
+#include "xaxivdma.h"
+#include "sleep.h"
+#include "xstatus.h"
+
+#include "renderer.h"
+#include "display_ctrl/display_ctrl.h"
+
+//frames of scanout to let the new mode settle before measuring
+#define DDR_BENCH_SETTLE_US 100000
+
+typedef struct {
+	u32 fill_mbps;
+	u32 copy_mbps;
+} ddr_bench_result_s;
+
+static const VideoMode *ddr_bench_modes[] = {
+	&VMODE_640x480,
+	&VMODE_800x600,
+	&VMODE_1280x720,
+	&VMODE_1280x1024,
+	&VMODE_1600x900,
+	&VMODE_1920x1080
+};
+
+//MB/s of the best pass, bytes per us is MB per second
+static u32 ddr_bench_mbps(XTime best){
+	u32 us = (u32)(best * 1000000 / COUNTS_PER_SECOND);
+
+	return us ? RENDERER_MAX_FRAME / us : 0;
+}
+
+static void ddr_bench_measure(u8 *frame, u8 *other, u32 iterations, ddr_bench_result_s *result){
+	XTime start;
+	XTime end;
+	XTime best_fill = ~0ULL;
+	XTime best_copy = ~0ULL;
+	u32 i;
+
+	for (i = 0; i < iterations; i++){
+		//fill, the same work as the clear and flush of a frame
+		XTime_GetTime(&start);
+		memset(frame, i, RENDERER_MAX_FRAME);
+		Xil_DCacheFlushRange((INTPTR)frame, RENDERER_MAX_FRAME);
+		XTime_GetTime(&end);
+		if (end - start < best_fill)
+			best_fill = end - start;
+
+		//copy, reads and writes a frame
+		XTime_GetTime(&start);
+		memcpy(other, frame, RENDERER_MAX_FRAME);
+		Xil_DCacheFlushRange((INTPTR)other, RENDERER_MAX_FRAME);
+		XTime_GetTime(&end);
+		if (end - start < best_copy)
+			best_copy = end - start;
+	}
+
+	result->fill_mbps = ddr_bench_mbps(best_fill);
+	result->copy_mbps = ddr_bench_mbps(best_copy);
+}
+
+static void ddr_bench_print_errors(u32 errors){
+	if (errors == 0){
+		xil_printf(" none");
+		return;
+	}
+
+	xil_printf(" 0x%03x", errors);
+	if (errors & XAXIVDMA_SR_ERR_INTERNAL_MASK)
+		xil_printf(" internal");
+	if (errors & XAXIVDMA_SR_ERR_SLAVE_MASK)
+		xil_printf(" slave");
+	if (errors & XAXIVDMA_SR_ERR_DECODE_MASK)
+		xil_printf(" decode");
+	if (errors & (XAXIVDMA_SR_ERR_FSZ_LESS_MASK | XAXIVDMA_SR_ERR_FSZ_MORE_MASK))
+		xil_printf(" frame-size");
+	if (errors & XAXIVDMA_SR_ERR_LSZ_LESS_MASK)
+		xil_printf(" line-size");
+}
+
+//percent of the stopped bandwidth lost
+static u32 ddr_bench_slowdown(u32 stopped, u32 loaded){
+	if (stopped == 0 || loaded >= stopped)
+		return 0;
+	return (stopped - loaded) * 100 / stopped;
+}
+
+void ddr_bench_run(u32 iterations){
+	ddr_bench_result_s stopped;
+	ddr_bench_result_s loaded;
+	const VideoMode *mode;
+	u32 scanout_mbps;
+	u32 refresh_x100;
+	u32 errors;
+	u8 *frame;
+	u8 *other;
+	u32 i;
+
+	if (iterations == 0)
+		iterations = DDR_BENCH_DEFAULT_ITERATIONS;
+
+	//two back buffers, neither is the one being scanned out
+	frame = renderer_get_frame_buffer(renderer_get_frame_index());
+	other = renderer_get_frame_buffer(renderer_get_frame_index() + 1 < DISPLAY_NUM_FRAMES ?
+			renderer_get_frame_index() + 1 : 1);
+
+	xil_printf("DDR contention benchmark, best of %d passes, %d KB per pass\n\r",
+			iterations, RENDERER_MAX_FRAME / 1024);
+	xil_printf("mode              refresh  scanout  fill MB/s      copy MB/s      vdma errors\n\r");
+
+	renderer_stop_display();
+	renderer_take_scanout_errors();
+	ddr_bench_measure(frame, other, iterations, &stopped);
+	xil_printf("stopped                 -        0  %9d       %9d       -\n\r",
+			stopped.fill_mbps, stopped.copy_mbps);
+
+	for (i = 0; i < sizeof(ddr_bench_modes) / sizeof(ddr_bench_modes[0]); i++){
+		mode = ddr_bench_modes[i];
+		//hmax and vmax are the last pixel and line of the blanking, not the totals
+		refresh_x100 = (u32)(mode->freq * 100000000.0 / ((mode->hmax + 1) * (mode->vmax + 1)));
+		scanout_mbps = (u32)((u64)mode->width * mode->height * 3 * refresh_x100 / 100000000);
+
+		if (renderer_set_mode(mode) != XST_SUCCESS){
+			xil_printf("%s: could not start the display\n\r", mode->label);
+			continue;
+		}
+		usleep(DDR_BENCH_SETTLE_US);
+		renderer_take_scanout_errors();
+
+		ddr_bench_measure(frame, other, iterations, &loaded);
+		errors = renderer_take_scanout_errors();
+
+		xil_printf("%-16s %4d.%02d %8d  %9d (-%2d%%) %9d (-%2d%%)",
+				mode->label, refresh_x100 / 100, refresh_x100 % 100, scanout_mbps,
+				loaded.fill_mbps, ddr_bench_slowdown(stopped.fill_mbps, loaded.fill_mbps),
+				loaded.copy_mbps, ddr_bench_slowdown(stopped.copy_mbps, loaded.copy_mbps));
+		ddr_bench_print_errors(errors);
+		xil_printf("\n\r");
+	}
+
+	renderer_set_mode(&VMODE_1920x1080);
+}
@@ -0,0 +1,21 @@
+#ifndef DDR_BENCH_H
+#define DDR_BENCH_H
+
+#include "xil_types.h"
+
+/*
+ * DDR contention benchmark: measures CPU frame fill (memset + cache flush)
+ * and frame copy (memcpy + flush) bandwidth with the display stopped and
+ * then with the VDMA scanning out each video mode, recording the VDMA read
+ * channel errors raised during each run. The slowdown against the stopped
+ * run is what scanout costs the render path; errors mean the scanout itself
+ * is starved.
+ *
+ * Leaves the display running at 1920x1080 when it returns.
+ */
+
+#define DDR_BENCH_DEFAULT_ITERATIONS 10
+
+void ddr_bench_run(u32 iterations);
+
+#endif //DDR_BENCH_H
@@ -0,0 +1,183 @@
+#include "deadline.h"
+
+#include <string.h>
+#include "xparameters.h"
+#include "xscuwdt.h"
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "interrupts.h"
+#include "profiler.h"
+
+//the private watchdog runs on PERIPHCLK like the global timer,
+//multiplied first as that is not a whole number of counts per us
+#define DEADLINE_US_TO_COUNTS(us) ((u32)((XTime)(us) * COUNTS_PER_SECOND / 1000000))
+
+static XScuWdt deadline_timer;
+static int deadline_ready;
+static const GameState *deadline_game;
+
+static deadline_overrun_s deadline_log[DEADLINE_LOG_SIZE];
+static volatile u32 deadline_count; //total overruns, the ring index is deadline_count % DEADLINE_LOG_SIZE
+static u32 deadline_reported;
+
+static u32 deadline_frame;
+static XTime deadline_frame_start;
+static volatile int deadline_expired; //set by the interrupt for the current frame
+
+//overruns per second for the last 60 seconds
+static u16 deadline_seconds[60];
+static u32 deadline_second; //seconds since boot of the newest slot
+
+//moves the per second window up to now, zeroing the seconds that passed
+static void deadline_advance(XTime now){
+	u32 second = (u32)(now / COUNTS_PER_SECOND);
+
+	if (second - deadline_second >= 60)
+		memset(deadline_seconds, 0, sizeof(deadline_seconds));
+	else
+		while (deadline_second != second)
+			deadline_seconds[++deadline_second % 60] = 0;
+	deadline_second = second;
+}
+
+static void deadline_interrupt(void *ref){
+	deadline_overrun_s *overrun;
+	profiler_s *zone;
+
+	XScuWdt_WriteReg(deadline_timer.Config.BaseAddr, XSCUWDT_ISR_OFFSET, XSCUWDT_ISR_EVENT_FLAG_MASK);
+
+	overrun = &deadline_log[deadline_count & (DEADLINE_LOG_SIZE - 1)];
+	memset(overrun, 0, sizeof(*overrun));
+	XTime_GetTime(&overrun->time);
+	overrun->frame = deadline_frame;
+
+	zone = profiler_get_current();
+	if (zone){
+		overrun->zone = zone->name;
+		overrun->zone_depth = zone->depth;
+	}
+
+	if (deadline_game){
+		overrun->ball_x = SCALAR_TO_INT(deadline_game->ball.x);
+		overrun->ball_y = SCALAR_TO_INT(deadline_game->ball.y);
+		overrun->ball_vx = SCALAR_TO_INT(deadline_game->ball.vx);
+		overrun->ball_vy = SCALAR_TO_INT(deadline_game->ball.vy);
+		overrun->paddle_x = SCALAR_TO_INT(deadline_game->paddle.x);
+		overrun->score = deadline_game->score;
+		overrun->lives = deadline_game->lives;
+		overrun->bricks_remaining = deadline_game->bricks_remaining;
+	}
+
+	deadline_advance(overrun->time);
+	deadline_seconds[deadline_second % 60]++;
+	deadline_expired = TRUE;
+	deadline_count++;
+}
+
+int deadline_initialize(const GameState *game){
+	XScuWdt_Config *config;
+	int status;
+
+	deadline_game = game;
+	if (deadline_ready)
+		return XST_SUCCESS;
+
+	config = XScuWdt_LookupConfig(XPAR_SCUWDT_0_DEVICE_ID);
+	if (config == NULL)
+		return XST_FAILURE;
+	status = XScuWdt_CfgInitialize(&deadline_timer, config, config->BaseAddr);
+	if (status != XST_SUCCESS){
+		xil_printf("deadline: watchdog init failed %d\n\r", status);
+		return XST_FAILURE;
+	}
+
+	//timer mode, one-shot (no auto reload), interrupt enabled
+	XScuWdt_SetTimerMode(&deadline_timer);
+	XScuWdt_SetControlReg(&deadline_timer, XSCUWDT_CONTROL_IT_ENABLE_MASK);
+
+	status = interrupts_connect(XPAR_SCUWDT_INTR, deadline_interrupt, NULL, INTERRUPTS_PRIORITY_NORMAL);
+	if (status != XST_SUCCESS)
+		return XST_FAILURE;
+
+	deadline_ready = TRUE;
+	return XST_SUCCESS;
+}
+
+void deadline_arm(u32 frame, u32 budget_us){
+	if (!deadline_ready)
+		return;
+
+	XTime_GetTime(&deadline_frame_start);
+	deadline_frame = frame;
+	deadline_expired = FALSE;
+
+	//loading the counter restarts the countdown
+	XScuWdt_Stop(&deadline_timer);
+	XScuWdt_LoadWdt(&deadline_timer, DEADLINE_US_TO_COUNTS(budget_us));
+	XScuWdt_Start(&deadline_timer);
+}
+
+void deadline_disarm(){
+	XTime now;
+
+	if (!deadline_ready)
+		return;
+
+	XScuWdt_Stop(&deadline_timer);
+	if (deadline_expired){
+		XTime_GetTime(&now);
+		deadline_log[(deadline_count - 1) & (DEADLINE_LOG_SIZE - 1)].frame_us =
+				(u32)(((now - deadline_frame_start) * PROFILER_US_PER_COUNT_Q32) >> 32);
+	}
+}
+
+u32 deadline_missed_total(){
+	return deadline_count;
+}
+
+u32 deadline_missed_per_minute(){
+	XTime now;
+	u32 total = 0;
+	int i;
+
+	XTime_GetTime(&now);
+	Xil_ExceptionDisable();
+	deadline_advance(now);
+	for (i = 0; i < 60; i++)
+		total += deadline_seconds[i];
+	Xil_ExceptionEnable();
+	return total;
+}
+
+//prints the overruns logged since the previous report, returns the count they run up to
+static u32 deadline_print_since_report(){
+	deadline_overrun_s *overrun;
+	u32 count = deadline_count;
+	u32 first = deadline_reported;
+	u32 i;
+
+	xil_printf("missed frames: %d total, %d in the last minute\n\r",
+			count, deadline_missed_per_minute());
+
+	//the oldest unreported entries may have been overwritten
+	if (count - first > DEADLINE_LOG_SIZE)
+		first = count - DEADLINE_LOG_SIZE;
+
+	for (i = first; i < count; i++){
+		overrun = &deadline_log[i & (DEADLINE_LOG_SIZE - 1)];
+		xil_printf("  frame %d took %d us in %s (depth %d): ball %d,%d v %d,%d paddle %d score %d lives %d bricks %d\n\r",
+				overrun->frame, overrun->frame_us,
+				overrun->zone ? overrun->zone : "-", overrun->zone_depth,
+				overrun->ball_x, overrun->ball_y, overrun->ball_vx, overrun->ball_vy,
+				overrun->paddle_x, overrun->score, overrun->lives, overrun->bricks_remaining);
+	}
+	return count;
+}
+
+void deadline_print(){
+	deadline_print_since_report();
+}
+
+void deadline_report(){
+	deadline_reported = deadline_print_since_report();
+}
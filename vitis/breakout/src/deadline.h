@@ -0,0 +1,52 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include "xil_types.h"
+#include "xtime_l.h"
+#include "breakout_game.h"
+
+/*
+ * Frame deadline supervisor: the SCU watchdog in timer mode is armed as a
+ * one-shot at the start of every frame. If the frame's work is still running
+ * when it expires, the interrupt snapshots the innermost profiler zone and
+ * the game state into a ring of overruns, so a stutter shows where the time
+ * went instead of just a skipped usleep.
+ */
+
+//must be a power of two
+#define DEADLINE_LOG_SIZE 64
+
+typedef struct {
+	u32 frame;
+	XTime time;         //when the deadline expired
+	const char *zone;   //innermost profiler zone open at expiry (NULL if none)
+	u32 zone_depth;
+	u32 frame_us;       //length of the whole frame, filled in by deadline_disarm
+
+	//game state at expiry, in pixels
+	s32 ball_x;
+	s32 ball_y;
+	s32 ball_vx;
+	s32 ball_vy;
+	s32 paddle_x;
+	s32 score;
+	s32 lives;
+	s32 bricks_remaining;
+} deadline_overrun_s;
+
+//game may be NULL, then the game state fields stay 0
+int deadline_initialize(const GameState *game);
+//starts the one-shot deadline budget_us from now for the given frame
+void deadline_arm(u32 frame, u32 budget_us);
+//call when the frame's work is done, before sleeping off the rest of the budget
+void deadline_disarm();
+
+u32 deadline_missed_total();
+//overruns in the last 60 seconds
+u32 deadline_missed_per_minute();
+//prints the overruns logged since the previous report
+void deadline_print();
+//deadline_print, then marks those overruns as reported
+void deadline_report();
+
+#endif //DEADLINE_H
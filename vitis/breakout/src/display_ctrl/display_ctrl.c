@@ -68,6 +68,39 @@
 /*				Procedure Definitions							*/
 /* ------------------------------------------------------------ */
 
+/***	DisplayFindClk(double freq, ClkMode *clkMode, ClkConfig *clkReg)
+**
+**	Parameters:
+**		freq - Required pixel clock frequency, in MHz
+**		clkMode - Pointer to the ClkMode struct to fill
+**		clkReg - Pointer to the ClkConfig struct to fill
+**
+**	Return Value: int
+**		XST_SUCCESS if successful, XST_FAILURE otherwise
+**
+**	Description:
+**		Gets the PLL parameters and register values for freq. Every mode in
+**		vga_modes.h is in the precomputed table (see ClkLookup), other
+**		frequencies are searched for with ClkFindParams.
+**
+*/
+static int DisplayFindClk(double freq, ClkMode *clkMode, ClkConfig *clkReg)
+{
+	if (ClkLookup(freq, clkMode, clkReg))
+	{
+		return XST_SUCCESS;
+	}
+
+	ClkFindParams(freq, clkMode);
+	if (!ClkFindReg(clkReg, clkMode))
+	{
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+/* ------------------------------------------------------------ */
+
 /***	DisplayStop(DisplayCtrl *dispPtr)
 **
 **	Parameters:
@@ -159,9 +192,14 @@ int DisplayStart(DisplayCtrl *dispPtr)
 
 
 	/*
-	 * Calculate the PLL divider parameters based on the required pixel clock frequency
+	 * Get the PLL divider parameters and register values for the required pixel clock
+	 * frequency, from the precomputed table when it has the mode
 	 */
-	ClkFindParams(dispPtr->vMode.freq, &clkMode);
+	if (DisplayFindClk(dispPtr->vMode.freq, &clkMode, &clkReg) != XST_SUCCESS)
+	{
+		xdbg_printf(XDBG_DEBUG_GENERAL, "Error calculating CLK register values\n\r");
+		return XST_FAILURE;
+	}
 
 	/*
 	 * Store the obtained frequency to pxlFreq. It is possible that the PLL was not able to
@@ -173,11 +211,6 @@ int DisplayStart(DisplayCtrl *dispPtr)
 	 * Write to the PLL dynamic configuration registers to configure it with the calculated
 	 * parameters.
 	 */
-	if (!ClkFindReg(&clkReg, &clkMode))
-	{
-		xdbg_printf(XDBG_DEBUG_GENERAL, "Error calculating CLK register values\n\r");
-		return XST_FAILURE;
-	}
 	ClkWriteReg(&clkReg, dispPtr->dynClkAddr);
 
 	/*
@@ -333,7 +366,11 @@ int DisplayInitialize(DisplayCtrl *dispPtr, XAxiVdma *vdma, u16 vtcId, u32 dynCl
 	dispPtr->vMode = VMODE_1920x1080;
 //	dispPtr->vMode = VMODE_1280x720;
 
-	ClkFindParams(dispPtr->vMode.freq, &clkMode);
+	if (DisplayFindClk(dispPtr->vMode.freq, &clkMode, &clkReg) != XST_SUCCESS)
+	{
+		xdbg_printf(XDBG_DEBUG_GENERAL, "Error calculating CLK register values\n\r");
+		return XST_FAILURE;
+	}
 
 	/*
 	 * Store the obtained frequency to pxlFreq. It is possible that the PLL was not able to
@@ -345,11 +382,6 @@ int DisplayInitialize(DisplayCtrl *dispPtr, XAxiVdma *vdma, u16 vtcId, u32 dynCl
 	 * Write to the PLL dynamic configuration registers to configure it with the calculated
 	 * parameters.
 	 */
-	if (!ClkFindReg(&clkReg, &clkMode))
-	{
-		xdbg_printf(XDBG_DEBUG_GENERAL, "Error calculating CLK register values\n\r");
-		return XST_FAILURE;
-	}
 	ClkWriteReg(&clkReg, dispPtr->dynClkAddr);
 
 	/*
@@ -0,0 +1,92 @@
+#include "dma.h"
+
+#include <string.h>
+#include "xparameters.h"
+#include "xdmaps.h"
+#include "xil_cache.h"
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "interrupts.h"
+
+#define DMA_CHANNEL 0
+
+static XDmaPs dma;
+static XDmaPs_Cmd dma_cmd;
+static int dma_ready;
+static volatile int dma_done;
+
+static void dma_done_handler(unsigned int channel, XDmaPs_Cmd *cmd, void *ref){
+	dma_done = TRUE;
+}
+
+//a fault leaves the error in the command's DmaStatus
+static void dma_fault_handler(unsigned int channel, XDmaPs_Cmd *cmd, void *ref){
+	dma_done = TRUE;
+}
+
+int dma_initialize(){
+	XDmaPs_Config *config;
+	int status;
+
+	if (dma_ready)
+		return XST_SUCCESS;
+
+	config = XDmaPs_LookupConfig(XPAR_XDMAPS_0_DEVICE_ID);
+	if (config == NULL)
+		return XST_FAILURE;
+	status = XDmaPs_CfgInitialize(&dma, config, config->BaseAddress);
+	if (status != XST_SUCCESS){
+		xil_printf("dma: init failed %d\n\r", status);
+		return XST_FAILURE;
+	}
+
+	status = interrupts_connect(XPAR_XDMAPS_0_FAULT_INTR,
+			(Xil_InterruptHandler)XDmaPs_FaultISR, &dma, INTERRUPTS_PRIORITY_NORMAL);
+	if (status == XST_SUCCESS)
+		status = interrupts_connect(XPAR_XDMAPS_0_DONE_INTR_0,
+				(Xil_InterruptHandler)XDmaPs_DoneISR_0, &dma, INTERRUPTS_PRIORITY_NORMAL);
+	if (status != XST_SUCCESS)
+		return XST_FAILURE;
+
+	XDmaPs_SetDoneHandler(&dma, DMA_CHANNEL, dma_done_handler, NULL);
+	XDmaPs_SetFaultHandler(&dma, dma_fault_handler, NULL);
+	dma_ready = TRUE;
+	return XST_SUCCESS;
+}
+
+int dma_copy_start(void *dst, const void *src, u32 length){
+	int status;
+
+	if (!dma_ready && dma_initialize() != XST_SUCCESS)
+		return XST_FAILURE;
+
+	//the source must be in DDR and the destination must not be written back over the copy
+	Xil_DCacheFlushRange((INTPTR)src, length);
+	Xil_DCacheFlushRange((INTPTR)dst, length);
+
+	memset(&dma_cmd, 0, sizeof(dma_cmd));
+	//16 beats of 8 bytes, the width of the DMA controller's AXI master
+	dma_cmd.ChanCtrl.SrcBurstSize = 8;
+	dma_cmd.ChanCtrl.SrcBurstLen = 16;
+	dma_cmd.ChanCtrl.SrcInc = 1;
+	dma_cmd.ChanCtrl.DstBurstSize = 8;
+	dma_cmd.ChanCtrl.DstBurstLen = 16;
+	dma_cmd.ChanCtrl.DstInc = 1;
+	dma_cmd.BD.SrcAddr = (u32)src;
+	dma_cmd.BD.DstAddr = (u32)dst;
+	dma_cmd.BD.Length = length;
+
+	dma_done = FALSE;
+	status = XDmaPs_Start(&dma, DMA_CHANNEL, &dma_cmd, 0);
+	if (status != XST_SUCCESS){
+		xil_printf("dma: start failed %d\n\r", status);
+		return XST_FAILURE;
+	}
+	return XST_SUCCESS;
+}
+
+int dma_copy_wait(){
+	while (!dma_done)
+		;
+	return dma_cmd.DmaStatus;
+}
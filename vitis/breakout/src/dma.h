@@ -0,0 +1,21 @@
+#ifndef DMA_H
+#define DMA_H
+
+#include "xil_types.h"
+
+/*
+ * Memory to memory copies on the PS DMA controller (PL330), one channel,
+ * completion signalled by its done interrupt (see interrupts.h).
+ */
+
+int dma_initialize();
+
+/*
+ * Flushes both ranges from the caches and starts the copy. The CPU must not
+ * touch the destination until dma_copy_wait returns.
+ */
+int dma_copy_start(void *dst, const void *src, u32 length);
+//returns the DMA status of the copy (0 when it succeeded)
+int dma_copy_wait();
+
+#endif //DMA_H
@@ -71,6 +71,7 @@
  */
 
 #include "dynclk.h"
+#include "dynclk_table.h"
 #include "xil_io.h"
 #include "math.h"
 
@@ -218,6 +219,30 @@ double ClkFindParams(double freq, ClkMode *bestPick)
 	return bestError;
 }
 
+/*
+ * Looks up the PLL parameters and register values for freq in the table generated
+ * by tools/gen_dynclk_table.py, which holds what ClkFindParams and ClkFindReg return
+ * for every mode in vga_modes.h. This skips the ~500 iteration double precision
+ * search on a mode switch. Returns 0 if freq is not in the table, in which case the
+ * caller should fall back to ClkFindParams and ClkFindReg.
+ */
+u32 ClkLookup(double freq, ClkMode *clkParams, ClkConfig *regValues)
+{
+	u32 i;
+
+	for (i = 0; i < sizeof(clk_table) / sizeof(clk_table[0]); i++)
+	{
+		if (clk_table[i].freq == freq)
+		{
+			*clkParams = clk_table[i].mode;
+			*regValues = clk_table[i].config;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 
 void ClkStart(u32 dynClkAddr)
 {
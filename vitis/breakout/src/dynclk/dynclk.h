@@ -266,6 +266,7 @@ u32 ClkDivider(u32 divide);
 u32 ClkFindReg (ClkConfig *regValues, ClkMode *clkParams);
 void ClkWriteReg (ClkConfig *regValues, u32 dynClkAddr);
 double ClkFindParams(double freq, ClkMode *bestPick);
+u32 ClkLookup(double freq, ClkMode *clkParams, ClkConfig *regValues);
 void ClkStart(u32 dynClkAddr);
 void ClkStop(u32 dynClkAddr);
 
@@ -0,0 +1,51 @@
+/*
+ * Generated by tools/gen_dynclk_table.py from display_ctrl/vga_modes.h, do not edit.
+ * PLL parameters and register values that ClkFindParams and ClkFindReg
+ * produce for each video mode's pixel clock, see ClkLookup.
+ */
+
+#ifndef DYNCLK_TABLE_H_
+#define DYNCLK_TABLE_H_
+
+#include "dynclk.h"
+
+typedef struct {
+		double freq; /* Requested pixel clock, as written in vga_modes.h */
+		ClkMode mode;
+		ClkConfig config;
+} ClkTableEntry;
+
+static const ClkTableEntry clk_table[] = {
+	{ /* VMODE_640x480 */
+		.freq = 25.0,
+		.mode = { .freq = 25.0, .fbmult = 10, .clkdiv = 8, .maindiv = 1 },
+		.config = { 0x00000104, 0x00000145, 0x00000000, 0x00001041, 0x3E8FA401, 0x004B00E7 }
+	},
+	{ /* VMODE_800x600 */
+		.freq = 40.0,
+		.mode = { .freq = 40.0, .fbmult = 6, .clkdiv = 3, .maindiv = 1 },
+		.config = { 0x00800042, 0x000000C3, 0x00000000, 0x00001041, 0x7E8FA401, 0x0073008C }
+	},
+	{ /* VMODE_1280x1024 */
+		.freq = 108.0,
+		.mode = { .freq = 108.0, .fbmult = 54, .clkdiv = 2, .maindiv = 5 },
+		.config = { 0x00000041, 0x000006DB, 0x00000000, 0x00002083, 0xCFAFA401, 0x00A300FF }
+	},
+	{ /* VMODE_1280x720 */
+		.freq = 74.25,
+		.mode = { .freq = 74.28571428571429, .fbmult = 52, .clkdiv = 2, .maindiv = 7 },
+		.config = { 0x00000041, 0x0000069A, 0x00000000, 0x000020C4, 0xCFAFA401, 0x00A300FF }
+	},
+	{ /* VMODE_1600x900 */
+		.freq = 97.75,
+		.mode = { .freq = 97.5, .fbmult = 39, .clkdiv = 2, .maindiv = 4 },
+		.config = { 0x00000041, 0x008004D4, 0x00000000, 0x00000082, 0xCFAFA401, 0x009300FF }
+	},
+	{ /* VMODE_1920x1080 */
+		.freq = 148.5,
+		.mode = { .freq = 148.57142857142858, .fbmult = 52, .clkdiv = 1, .maindiv = 7 },
+		.config = { 0x00400041, 0x0000069A, 0x00000000, 0x000020C4, 0xCFAFA401, 0x00A300FF }
+	},
+};
+
+#endif /* DYNCLK_TABLE_H_ */
@@ -0,0 +1,36 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include "xil_types.h"
+
+/*
+ * Q16.16 fixed-point math used by the deterministic physics path.
+ * Everything here is integer-only so the results are bit-identical
+ * on the board and on any host build.
+ */
+
+typedef s32 fixed_t;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE   (1 << FIXED_SHIFT)
+
+#define FIXED_FROM_INT(i) ((fixed_t)((i) * FIXED_ONE))
+//arithmetic shift, so negative values round towards negative infinity
+#define FIXED_TO_INT(f)   ((int)((f) >> FIXED_SHIFT))
+#define FIXED_MUL(a, b)   ((fixed_t)(((s64)(a) * (s64)(b)) >> FIXED_SHIFT))
+#define FIXED_DIV(a, b)   ((fixed_t)(((s64)(a) << FIXED_SHIFT) / (b)))
+
+/*
+ * Angles are binary angle units: FIXED_ANGLE_FULL units make one full turn,
+ * so the sine table only has to cover a quarter turn.
+ */
+#define FIXED_ANGLE_FULL    1024
+#define FIXED_ANGLE_QUARTER (FIXED_ANGLE_FULL / 4)
+#define FIXED_DEGREES(d)    ((d) * FIXED_ANGLE_FULL / 360)
+
+fixed_t fixed_sin(int angle);
+fixed_t fixed_cos(int angle);
+//square root of a non-negative Q16.16 value
+fixed_t fixed_sqrt(fixed_t value);
+
+#endif //FIXED_H
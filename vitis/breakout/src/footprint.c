@@ -0,0 +1,135 @@
+#include "footprint.h"
+
+#include <malloc.h>
+#include "xstatus.h"
+#include "xil_printf.h"
+
+//linker script symbols
+extern char __text_start[], __text_end[];
+extern char __rodata_start[], __rodata_end[];
+extern char __data_start[], __data_end[];
+extern char __ocm_text_start[], __ocm_text_end[];
+extern char __ocm_data_start[], __ocm_data_end[];
+extern char __ocm_bss_start[], __ocm_bss_end[];
+extern char __mmu_tbl_start[], __mmu_tbl_end[];
+extern char __bss_start[], __bss_end[];
+extern char _heap_start[], _heap_end[];
+extern u32 _stack_end[], __stack[];
+extern u32 _irq_stack_end[], __irq_stack[];
+extern u32 _supervisor_stack_end[], __supervisor_stack[];
+extern u32 _abort_stack_end[], __abort_stack[];
+extern u32 _fiq_stack_end[], __fiq_stack[];
+extern u32 _undef_stack_end[], __undef_stack[];
+
+typedef struct {
+	const char *name;
+	u32 *bottom;  //lowest word, stacks grow down towards it
+	u32 *top;
+} footprint_stack_s;
+
+static const footprint_stack_s footprint_stacks[] = {
+	{"user", _stack_end, __stack},
+	{"irq", _irq_stack_end, __irq_stack},
+	{"supervisor", _supervisor_stack_end, __supervisor_stack},
+	{"abort", _abort_stack_end, __abort_stack},
+	{"fiq", _fiq_stack_end, __fiq_stack},
+	{"undef", _undef_stack_end, __undef_stack}
+};
+
+#define FOOTPRINT_STACKS (sizeof(footprint_stacks) / sizeof(footprint_stacks[0]))
+
+static int footprint_painted;
+
+void footprint_paint_stacks(){
+	//the stack this runs on, anything above it is live
+	u32 *live = (u32 *)__builtin_frame_address(0) - FOOTPRINT_PAINT_MARGIN / sizeof(u32);
+	const footprint_stack_s *stack;
+	u32 *word;
+	u32 *end;
+	u32 i;
+
+	for (i = 0; i < FOOTPRINT_STACKS; i++){
+		stack = &footprint_stacks[i];
+		end = stack->top;
+		if (live >= stack->bottom && live < stack->top)
+			end = live;
+		for (word = stack->bottom; word < end; word++)
+			*word = FOOTPRINT_PAINT;
+	}
+	footprint_painted = TRUE;
+}
+
+//deepest use in bytes, the whole stack if even the bottom word was overwritten
+static u32 footprint_stack_used(const footprint_stack_s *stack){
+	u32 *word = stack->bottom;
+
+	while (word < stack->top && *word == FOOTPRINT_PAINT)
+		word++;
+	return (u32)(stack->top - word) * sizeof(u32);
+}
+
+static void footprint_print_section(const char *name, char *start, char *end){
+	xil_printf("  %-12s 0x%08x %9d bytes\n\r", name, (u32)start, (u32)(end - start));
+}
+
+static void footprint_print_stacks(int only_warnings){
+	const footprint_stack_s *stack;
+	u32 size;
+	u32 used;
+	u32 i;
+
+	for (i = 0; i < FOOTPRINT_STACKS; i++){
+		stack = &footprint_stacks[i];
+		size = (u32)(stack->top - stack->bottom) * sizeof(u32);
+		used = footprint_stack_used(stack);
+		if (only_warnings && used * 100 <= size * FOOTPRINT_WARN_PERCENT)
+			continue;
+		xil_printf("  stack %-10s %6d of %6d bytes %3d%%%s\n\r", stack->name, used, size,
+				size ? used * 100 / size : 0, used >= size ? " OVERFLOWED" : "");
+	}
+}
+
+void footprint_report(){
+	struct mallinfo heap = mallinfo();
+
+	xil_printf("footprint:\n\r");
+	footprint_print_section(".text", __text_start, __text_end);
+	footprint_print_section(".rodata", __rodata_start, __rodata_end);
+	footprint_print_section(".data", __data_start, __data_end);
+	footprint_print_section(".bss", __bss_start, __bss_end);
+	footprint_print_section(".mmu_tbl", __mmu_tbl_start, __mmu_tbl_end);
+	footprint_print_section(".ocm_text", __ocm_text_start, __ocm_text_end);
+	footprint_print_section(".ocm_data", __ocm_data_start, __ocm_data_end);
+	footprint_print_section(".ocm_bss", __ocm_bss_start, __ocm_bss_end);
+	footprint_print_section(".heap", _heap_start, _heap_end);
+
+	//arena is what malloc has taken from the heap section, uordblks what is allocated now
+	xil_printf("  heap %d of %d bytes taken by malloc, %d in use\n\r",
+			heap.arena, (u32)(_heap_end - _heap_start), heap.uordblks);
+
+	if (!footprint_painted){
+		xil_printf("  stacks not painted\n\r");
+		return;
+	}
+	footprint_print_stacks(FALSE);
+}
+
+int footprint_check(){
+	const footprint_stack_s *stack;
+	u32 size;
+	u32 i;
+
+	if (!footprint_painted)
+		return XST_SUCCESS;
+
+	for (i = 0; i < FOOTPRINT_STACKS; i++){
+		stack = &footprint_stacks[i];
+		size = (u32)(stack->top - stack->bottom) * sizeof(u32);
+		if (footprint_stack_used(stack) * 100 > size * FOOTPRINT_WARN_PERCENT){
+			xil_printf("footprint: stack close to full\n\r");
+			footprint_print_stacks(TRUE);
+			return XST_FAILURE;
+		}
+	}
+	return XST_SUCCESS;
+}
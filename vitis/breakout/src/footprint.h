@@ -0,0 +1,29 @@
+#ifndef FOOTPRINT_H
+#define FOOTPRINT_H
+
+#include "xil_types.h"
+
+/*
+ * Memory footprint: the size of every part of the image from the linker
+ * script symbols, heap use, and the high water mark of each processor mode
+ * stack. init_platform() paints the stacks with FOOTPRINT_PAINT before
+ * interrupts are enabled; the deepest word that no longer holds the pattern
+ * is the most that stack has used.
+ *
+ * The IRQ stack sits directly above the user stack (see lscript.ld), so an
+ * IRQ stack overflow lands on main's oldest frames, where GameState lives.
+ */
+
+#define FOOTPRINT_PAINT        0xC0DEFEEDU
+//the live part of the current stack that painting leaves alone
+#define FOOTPRINT_PAINT_MARGIN 256
+//footprint_check() warns when a stack has used more than this
+#define FOOTPRINT_WARN_PERCENT 75
+
+void footprint_paint_stacks();
+//prints section sizes, heap use and stack high water marks
+void footprint_report();
+//quick check of the stack high water marks, prints and returns XST_FAILURE only when one is close to full
+int footprint_check();
+
+#endif //FOOTPRINT_H
@@ -0,0 +1,196 @@
+#include "frameclock.h"
+
+#include "xparameters.h"
+#include "xscutimer.h"
+#include "xstatus.h"
+#include "xil_exception.h"
+#include "xil_printf.h"
+#include "interrupts.h"
+#include "profiler.h"
+#include "sampler.h"
+
+//multiplies before dividing, COUNTS_PER_SECOND is not a whole number of counts per us
+#define FRAMECLOCK_US_TO_COUNTS(us) ((XTime)(us) * COUNTS_PER_SECOND / 1000000)
+#define FRAMECLOCK_TO_US(counts) ((u32)(((counts) * PROFILER_US_PER_COUNT_Q32) >> 32))
+
+typedef struct {
+	frameclock_idle_task task;
+	void *ref;
+} frameclock_idle_s;
+
+static XScuTimer frameclock_timer;
+static int frameclock_ready;
+static int frameclock_timer_connected;
+static volatile int frameclock_fired;
+
+static XTime frameclock_period;
+static XTime frameclock_next; //deadline of the frame in progress
+
+static frameclock_idle_s idle_tasks[FRAMECLOCK_MAX_IDLE_TASKS];
+static int idle_task_count;
+static int idle_task_next;    //round robin position
+
+//since the previous report
+static u32 stat_frames;
+static u32 stat_late_max_us;
+static u32 stat_late_sum_us;
+static u32 stat_sleep_us;
+static u32 stat_idle_us;
+static u32 stat_dropped;
+
+static void frameclock_interrupt(void *ref){
+	XScuTimer_ClearInterruptStatus(&frameclock_timer);
+	frameclock_fired = TRUE;
+}
+
+int frameclock_initialize(u32 period_us){
+	XScuTimer_Config *config;
+	XTime now;
+	int status;
+
+	frameclock_period = FRAMECLOCK_US_TO_COUNTS(period_us);
+	XTime_GetTime(&now);
+	frameclock_next = now + frameclock_period;
+	if (frameclock_ready)
+		return XST_SUCCESS;
+
+	config = XScuTimer_LookupConfig(XPAR_XSCUTIMER_0_DEVICE_ID);
+	if (config == NULL)
+		return XST_FAILURE;
+	status = XScuTimer_CfgInitialize(&frameclock_timer, config, config->BaseAddr);
+	if (status != XST_SUCCESS){
+		xil_printf("frameclock: timer init failed %d\n\r", status);
+		return XST_FAILURE;
+	}
+
+	frameclock_ready = TRUE;
+	return XST_SUCCESS;
+}
+
+void frameclock_set_period(u32 period_us){
+	frameclock_period = FRAMECLOCK_US_TO_COUNTS(period_us);
+}
+
+int frameclock_add_idle_task(frameclock_idle_task task, void *ref){
+	if (idle_task_count == FRAMECLOCK_MAX_IDLE_TASKS)
+		return XST_FAILURE;
+
+	idle_tasks[idle_task_count].task = task;
+	idle_tasks[idle_task_count].ref = ref;
+	idle_task_count++;
+	return XST_SUCCESS;
+}
+
+//runs the tasks in turn, starting after the last one that did work, until one does; TRUE if one did
+static int frameclock_run_idle(u32 budget_us){
+	frameclock_idle_s *idle;
+	int i;
+
+	for (i = 0; i < idle_task_count; i++){
+		idle = &idle_tasks[(idle_task_next + i) % idle_task_count];
+		if (idle->task(idle->ref, budget_us)){
+			idle_task_next = (idle_task_next + i + 1) % idle_task_count;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+//sleeps until the timer fires in the given number of counts, or any other interrupt
+static void frameclock_sleep(XTime counts){
+	if (sampler_running()){
+		//the sampler has the timer, its next tick is at most 1/hz away
+		frameclock_timer_connected = FALSE;
+	} else {
+		if (!frameclock_timer_connected){
+			if (interrupts_connect(XPAR_SCUTIMER_INTR, frameclock_interrupt, NULL, INTERRUPTS_PRIORITY_NORMAL) != XST_SUCCESS)
+				return;
+			frameclock_timer_connected = TRUE;
+		}
+		//the private timer and the global timer both run at half the CPU clock
+		frameclock_fired = FALSE;
+		XScuTimer_Stop(&frameclock_timer);
+		XScuTimer_DisableAutoReload(&frameclock_timer);
+		XScuTimer_LoadTimer(&frameclock_timer, (u32)counts);
+		XScuTimer_ClearInterruptStatus(&frameclock_timer);
+		XScuTimer_EnableInterrupt(&frameclock_timer);
+		XScuTimer_Start(&frameclock_timer);
+	}
+
+	/*
+	 * With IRQs masked, an interrupt that arrives after the check still wakes
+	 * the WFI and is taken as soon as they are unmasked again
+	 */
+	Xil_ExceptionDisable();
+	if (!frameclock_fired)
+		__asm__ __volatile__("wfi" ::: "memory");
+	Xil_ExceptionEnable();
+}
+
+void frameclock_wait(){
+	XTime now, start, late;
+	XTime deadline = frameclock_next;
+
+	if (!frameclock_ready)
+		return;
+
+	for (;;){
+		XTime_GetTime(&now);
+		if (now >= deadline)
+			break;
+
+		start = now;
+		if (deadline - now > FRAMECLOCK_US_TO_COUNTS(FRAMECLOCK_IDLE_GUARD_US) &&
+				frameclock_run_idle(FRAMECLOCK_TO_US(deadline - now) - FRAMECLOCK_IDLE_GUARD_US)){
+			XTime_GetTime(&now);
+			stat_idle_us += FRAMECLOCK_TO_US(now - start);
+			continue;
+		}
+
+		frameclock_sleep(deadline - now);
+		XTime_GetTime(&now);
+		stat_sleep_us += FRAMECLOCK_TO_US(now - start);
+	}
+
+	late = now - deadline;
+	stat_frames++;
+	stat_late_sum_us += FRAMECLOCK_TO_US(late);
+	if (FRAMECLOCK_TO_US(late) > stat_late_max_us)
+		stat_late_max_us = FRAMECLOCK_TO_US(late);
+
+	//a frame that overran whole periods starts a new schedule rather than rushing to catch up
+	frameclock_next = deadline + frameclock_period;
+	while (frameclock_next <= now){
+		frameclock_next += frameclock_period;
+		stat_dropped++;
+	}
+}
+
+XTime frameclock_deadline(){
+	return frameclock_next;
+}
+
+u32 frameclock_remaining_us(){
+	XTime now;
+
+	XTime_GetTime(&now);
+	if (now >= frameclock_next)
+		return 0;
+	return FRAMECLOCK_TO_US(frameclock_next - now);
+}
+
+void frameclock_print(){
+	xil_printf("frame clock: %d frames, wake late mean %d us max %d us, slept %d us, idle tasks %d us, %d deadlines dropped\n\r",
+			stat_frames, stat_frames ? stat_late_sum_us / stat_frames : 0, stat_late_max_us,
+			stat_sleep_us, stat_idle_us, stat_dropped);
+}
+
+void frameclock_report(){
+	frameclock_print();
+	stat_frames = 0;
+	stat_late_max_us = 0;
+	stat_late_sum_us = 0;
+	stat_sleep_us = 0;
+	stat_idle_us = 0;
+	stat_dropped = 0;
+}
@@ -0,0 +1,48 @@
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include "xil_types.h"
+#include "xtime_l.h"
+
+/*
+ * Frame clock: frames are paced against absolute XTime deadlines, one period
+ * apart, so the error of one frame does not carry into the next. While
+ * waiting for a deadline the registered idle tasks get the time first, then
+ * the core sleeps in WFI until the SCU private timer's one-shot interrupt.
+ *
+ * While the PC sampler (see sampler.h) owns the private timer, the sampler's
+ * own ticks wake the WFI instead.
+ */
+
+#define FRAMECLOCK_MAX_IDLE_TASKS 4
+//idle tasks are only run while at least this much time is left
+#define FRAMECLOCK_IDLE_GUARD_US  500
+
+/*
+ * Does background work that fits in budget_us, the time left before the
+ * deadline less FRAMECLOCK_IDLE_GUARD_US. Returns FALSE when there was nothing to do.
+ */
+typedef int (*frameclock_idle_task)(void *ref, u32 budget_us);
+
+int frameclock_initialize(u32 period_us);
+int frameclock_add_idle_task(frameclock_idle_task task, void *ref);
+//the new period applies from the deadline after the current one
+void frameclock_set_period(u32 period_us);
+
+/*
+ * Runs idle tasks and sleeps until the current frame's deadline, then moves
+ * the deadline on by one period. If the frame ran past one or more whole
+ * periods, those deadlines are dropped instead of being caught up.
+ */
+void frameclock_wait();
+//deadline of the frame in progress
+XTime frameclock_deadline();
+//time left until that deadline, 0 once it has passed
+u32 frameclock_remaining_us();
+
+//prints wake up lateness, sleep and idle task time and dropped deadlines since the previous report
+void frameclock_print();
+//frameclock_print, then starts a new report interval
+void frameclock_report();
+
+#endif //FRAMECLOCK_H
@@ -0,0 +1,98 @@
+#include "governor.h"
+
+#include "xil_printf.h"
+#include "xstatus.h"
+#include "renderer.h"
+#include "overlay.h"
+#include "display_ctrl/display_ctrl.h"
+
+static const VideoMode *governor_modes[GOVERNOR_LEVELS] = {
+	&VMODE_1920x1080,
+	&VMODE_1600x900,
+	&VMODE_1280x720
+};
+
+static u32 governor_budget_us;
+static int governor_on;
+static int governor_level;
+static u32 governor_smoothed_us; //exponential average over ~8 frames
+static u32 governor_over;        //consecutive frames over budget
+static u32 governor_under;       //consecutive frames the higher mode would fit
+static u32 governor_hold;        //frames left before another switch is allowed
+
+static u32 governor_pixels(int level){
+	return governor_modes[level]->width * governor_modes[level]->height;
+}
+
+static void governor_switch(int level){
+	if (renderer_set_mode(governor_modes[level]) != XST_SUCCESS){
+		xil_printf("governor: could not switch to %s\n\r", governor_modes[level]->label);
+		return;
+	}
+	xil_printf("governor: %s (smoothed frame %d us)\n\r",
+			governor_modes[level]->label, governor_smoothed_us);
+
+	governor_level = level;
+	governor_over = 0;
+	governor_under = 0;
+	governor_hold = GOVERNOR_HOLD_FRAMES;
+	//the graph area may have been cleared while it was outside the active area
+	if (overlay_enabled())
+		overlay_enable(1);
+}
+
+void governor_initialize(u32 budget_us){
+	governor_budget_us = budget_us;
+	governor_level = 0;
+	governor_smoothed_us = 0;
+	governor_over = 0;
+	governor_under = 0;
+	governor_hold = 0;
+}
+
+void governor_enable(int enable){
+	governor_on = enable;
+	if (!enable && governor_level != 0)
+		governor_switch(0);
+}
+
+void governor_update(u32 work_us){
+	u32 predicted_us;
+
+	if (!governor_on)
+		return;
+
+	if (governor_smoothed_us == 0)
+		governor_smoothed_us = work_us;
+	else
+		governor_smoothed_us = governor_smoothed_us - governor_smoothed_us / 8 + work_us / 8;
+
+	if (governor_hold){
+		governor_hold--;
+		return;
+	}
+
+	if (governor_smoothed_us > governor_budget_us)
+		governor_over++;
+	else
+		governor_over = 0;
+
+	//the work that scales with the mode is the clear, flush and draw, so predict by pixel count
+	if (governor_level > 0){
+		predicted_us = (u32)((u64)governor_smoothed_us * governor_pixels(governor_level - 1) /
+				governor_pixels(governor_level));
+		if (predicted_us * 100 < governor_budget_us * GOVERNOR_UP_PERCENT)
+			governor_under++;
+		else
+			governor_under = 0;
+	}
+
+	if (governor_over >= GOVERNOR_DOWN_FRAMES && governor_level < GOVERNOR_LEVELS - 1)
+		governor_switch(governor_level + 1);
+	else if (governor_under >= GOVERNOR_UP_FRAMES)
+		governor_switch(governor_level - 1);
+}
+
+int governor_get_level(){
+	return governor_level;
+}
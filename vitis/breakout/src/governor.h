@@ -0,0 +1,35 @@
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include "xil_types.h"
+
+/*
+ * Resolution governor: fed the frame's work time every frame, it drops to a
+ * cheaper video mode (1920x1080, 1600x900, 1280x720) after a sustained
+ * overrun of the budget and steps back up once the higher mode is predicted
+ * to fit with headroom. The thresholds are asymmetric and every switch is
+ * followed by a hold-off, so it does not oscillate between two modes.
+ *
+ * The game keeps 1920x1080 coordinates; render_game_hdmi scales them to the
+ * current mode.
+ */
+
+#define GOVERNOR_LEVELS 3
+
+//frames the smoothed work time must stay over budget before stepping down
+#define GOVERNOR_DOWN_FRAMES 30
+//frames the higher mode must be predicted under GOVERNOR_UP_PERCENT of budget before stepping up
+#define GOVERNOR_UP_FRAMES   180
+#define GOVERNOR_UP_PERCENT  80
+//frames after a switch during which no other switch happens
+#define GOVERNOR_HOLD_FRAMES 120
+
+void governor_initialize(u32 budget_us);
+void governor_enable(int enable);
+
+//call once per frame, outside the frame's zones, since a switch restarts the display
+void governor_update(u32 work_us);
+//0 is full resolution
+int governor_get_level();
+
+#endif //GOVERNOR_H
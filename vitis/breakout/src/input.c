@@ -0,0 +1,219 @@
+#include "input.h"
+
+#include "xil_printf.h"
+#include "xstatus.h"
+
+#include "autopilot.h"
+#include "buttons.h"
+#include "prng.h"
+#include "uart_io.h"
+
+#define INPUT_RECORD_MAGIC "BRKI"
+
+/*
+ * The recording is a ring of runs. If the ring fills up, the oldest runs are
+ * overwritten and the recording no longer starts at the first frame, which
+ * is reported as a warning when it is dumped or replayed.
+ */
+static input_run_s record_runs[INPUT_RECORD_MAX_RUNS];
+static u32 record_head;  //index of the oldest run
+static u32 record_count; //number of valid runs
+static int record_wrapped;
+static int recording;
+
+static u32 replay_run;   //offset from record_head of the run being played
+static u32 replay_frame; //frames already played from that run
+static int replay_exhausted; //set when a frame was asked for past the end
+
+static input_source_e input_source = INPUT_SOURCE_BUTTONS;
+
+static prng_s random_prng = {1};
+static u32 random_buttons;
+
+void input_set_source(input_source_e source){
+	input_source = source;
+	if (source == INPUT_SOURCE_REPLAY){
+		recording = FALSE;
+		input_replay_rewind();
+	}
+}
+
+input_source_e input_get_source(){
+	return input_source;
+}
+
+void input_set_random_seed(u32 seed){
+	prng_seed(&random_prng, seed);
+	random_buttons = 0;
+}
+
+//holds a random button state for a random number of frames, like a player would
+static u8 random_read(){
+	u32 r = prng_next(&random_prng);
+
+	if ((r & 0xF) == 0)
+		random_buttons = (r >> 4) & INPUT_BTN_MASK;
+	return random_buttons;
+}
+
+static input_run_s *record_run_at(u32 offset){
+	return &record_runs[(record_head + offset) % INPUT_RECORD_MAX_RUNS];
+}
+
+static void record_push(u8 buttons){
+	input_run_s *last;
+
+	if (record_count > 0){
+		last = record_run_at(record_count - 1);
+		if (last->buttons == buttons && last->frames != 0xFFFF){
+			last->frames++;
+			return;
+		}
+	}
+
+	if (record_count == INPUT_RECORD_MAX_RUNS){
+		//drop the oldest run to make room
+		record_head = (record_head + 1) % INPUT_RECORD_MAX_RUNS;
+		record_count--;
+		record_wrapped = TRUE;
+	}
+
+	last = record_run_at(record_count);
+	last->buttons = buttons;
+	last->reserved = 0;
+	last->frames = 1;
+	record_count++;
+}
+
+static u8 replay_next(){
+	input_run_s *run;
+
+	if (replay_run >= record_count){
+		replay_exhausted = TRUE;
+		return 0;
+	}
+
+	run = record_run_at(replay_run);
+	if (++replay_frame == run->frames){
+		replay_frame = 0;
+		replay_run++;
+	}
+	return run->buttons;
+}
+
+u32 input_read_buttons(){
+	u32 buttons;
+
+	if (input_source == INPUT_SOURCE_REPLAY)
+		return replay_next();
+
+	if (input_source == INPUT_SOURCE_RANDOM)
+		buttons = random_read();
+	else if (input_source == INPUT_SOURCE_AUTOPILOT)
+		buttons = autopilot_read_buttons();
+	else
+		buttons = buttons_read();
+	if (recording)
+		record_push((u8)buttons);
+	return buttons;
+}
+
+void input_record_start(){
+	record_head = 0;
+	record_count = 0;
+	record_wrapped = FALSE;
+	recording = TRUE;
+}
+
+void input_record_stop(){
+	recording = FALSE;
+}
+
+u32 input_record_frames(){
+	u32 frames = 0;
+	u32 i;
+
+	for (i = 0; i < record_count; i++)
+		frames += record_run_at(i)->frames;
+	return frames;
+}
+
+void input_replay_rewind(){
+	replay_run = 0;
+	replay_frame = 0;
+	replay_exhausted = FALSE;
+	if (record_wrapped)
+		xil_printf("WARNING: input recording overflowed, replay does not start at frame 0\n\r");
+}
+
+int input_replay_done(){
+	return replay_exhausted;
+}
+
+void input_record_dump_uart(){
+	const char *magic = INPUT_RECORD_MAGIC;
+	input_run_s *run;
+	u32 i;
+
+	if (record_wrapped)
+		xil_printf("WARNING: input recording overflowed, oldest frames were dropped\n\r");
+
+	for (i = 0; i < 4; i++)
+		outbyte(magic[i]);
+	uart_write_u32(record_count);
+	for (i = 0; i < record_count; i++){
+		run = record_run_at(i);
+		outbyte(run->buttons);
+		outbyte(run->reserved);
+		outbyte(run->frames & 0xFF);
+		outbyte(run->frames >> 8);
+	}
+}
+
+//blocks until a full recording has been received
+int input_record_load_uart(){
+	const char *magic = INPUT_RECORD_MAGIC;
+	input_run_s *run;
+	u32 count;
+	u32 empty = 0;
+	u32 i;
+
+	for (i = 0; i < 4; i++){
+		if (inbyte() != magic[i]){
+			xil_printf("Input recording load failed: bad magic\n\r");
+			return XST_FAILURE;
+		}
+	}
+
+	count = uart_read_u32();
+	if (count > INPUT_RECORD_MAX_RUNS){
+		xil_printf("Input recording load failed: %d runs is more than %d\n\r",
+				count, INPUT_RECORD_MAX_RUNS);
+		return XST_FAILURE;
+	}
+
+	recording = FALSE;
+	record_head = 0;
+	record_wrapped = FALSE;
+	for (i = 0; i < count; i++){
+		run = &record_runs[i];
+		run->buttons = (u8)inbyte();
+		run->reserved = (u8)inbyte();
+		run->frames = (u8)inbyte();
+		run->frames |= (u16)((u8)inbyte()) << 8;
+		//a 0 frame run would only be left when replay_frame wraps
+		if (run->frames == 0)
+			empty++;
+	}
+	if (empty > 0){
+		//the whole stream is read first so the UART is left in sync
+		xil_printf("Input recording load failed: %d runs have 0 frames\n\r", empty);
+		record_count = 0;
+		input_replay_rewind();
+		return XST_FAILURE;
+	}
+	record_count = count;
+	input_replay_rewind();
+
+	return XST_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "xil_types.h"
+
+//AXI GPIO connected to the four push buttons (axi_gpio_0 in the block design)
+#define INPUT_BTN_BASEADDR 0x41210000
+
+#define INPUT_BTN_RIGHT    0b0001
+#define INPUT_BTN_LAUNCH   0b0110
+#define INPUT_BTN_LEFT     0b1000
+#define INPUT_BTN_MASK     0b1111
+
+/*
+ * Maximum number of run-length encoded runs kept in RAM.
+ * Each run is 4 bytes and covers up to 65535 frames of the same button state.
+ */
+#define INPUT_RECORD_MAX_RUNS 8192
+
+typedef enum {
+	INPUT_SOURCE_BUTTONS = 0, //the push buttons, see buttons.h
+	INPUT_SOURCE_REPLAY  = 1, //feed back the recorded sequence
+	INPUT_SOURCE_RANDOM  = 2, //pseudo-random presses from a fixed seed
+	INPUT_SOURCE_AUTOPILOT = 3 //computer player, see autopilot.h
+} input_source_e;
+
+typedef struct {
+	u8 buttons;
+	u8 reserved;
+	u16 frames;
+} input_run_s;
+
+void input_set_source(input_source_e source);
+input_source_e input_get_source();
+//seeds INPUT_SOURCE_RANDOM, the same seed always produces the same sequence
+void input_set_random_seed(u32 seed);
+
+/*
+ * Returns the button state for the current frame from the selected source.
+ * Must be called exactly once per frame so recordings stay frame-accurate.
+ * If recording is on, the returned state is also appended to the recording.
+ */
+u32 input_read_buttons();
+
+void input_record_start();
+void input_record_stop();
+//total number of frames held in the recording
+u32 input_record_frames();
+
+//restarts playback from the first recorded frame
+void input_replay_rewind();
+/*
+ * TRUE once input_read_buttons() has been called after the last recorded
+ * frame was played back, so the frame that read the last recorded state
+ * still sees FALSE and can be applied.
+ */
+int input_replay_done();
+
+/*
+ * Binary dump/load of the recording over the stdout UART:
+ *   "BRKI" magic, u32 run count (little endian), then 4 bytes per run
+ */
+void input_record_dump_uart();
+int input_record_load_uart();
+
+#endif //INPUT_H
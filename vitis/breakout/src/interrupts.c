@@ -0,0 +1,70 @@
+#include "interrupts.h"
+
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xil_printf.h"
+
+//first private peripheral interrupt, they are edge triggered
+#define INTERRUPTS_PPI_FIRST 16
+#define INTERRUPTS_PPI_LAST  31
+//trigger field values for XScuGic_SetPriorityTriggerType
+#define INTERRUPTS_TRIGGER_LEVEL  0x1
+#define INTERRUPTS_TRIGGER_RISING 0x3
+
+XScuGic interrupts_gic;
+static int interrupts_ready;
+
+int interrupts_initialize(){
+	XScuGic_Config *config;
+	int status;
+
+	if (interrupts_ready)
+		return XST_SUCCESS;
+
+	config = XScuGic_LookupConfig(XPAR_SCUGIC_0_DEVICE_ID);
+	if (config == NULL){
+		xil_printf("interrupts: no GIC config\n\r");
+		return XST_FAILURE;
+	}
+	status = XScuGic_CfgInitialize(&interrupts_gic, config, config->CpuBaseAddress);
+	if (status != XST_SUCCESS){
+		xil_printf("interrupts: GIC init failed %d\n\r", status);
+		return XST_FAILURE;
+	}
+
+	Xil_ExceptionInit();
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+			(Xil_ExceptionHandler)XScuGic_InterruptHandler, &interrupts_gic);
+	Xil_ExceptionEnable();
+
+	interrupts_ready = TRUE;
+	return XST_SUCCESS;
+}
+
+int interrupts_connect(u32 id, Xil_InterruptHandler handler, void *ref, u8 priority){
+	int status;
+	u8 trigger;
+
+	if (interrupts_initialize() != XST_SUCCESS)
+		return XST_FAILURE;
+
+	status = XScuGic_Connect(&interrupts_gic, id, handler, ref);
+	if (status != XST_SUCCESS){
+		xil_printf("interrupts: connecting %d failed\n\r", id);
+		return XST_FAILURE;
+	}
+
+	trigger = (id >= INTERRUPTS_PPI_FIRST && id <= INTERRUPTS_PPI_LAST) ?
+			INTERRUPTS_TRIGGER_RISING : INTERRUPTS_TRIGGER_LEVEL;
+	XScuGic_SetPriorityTriggerType(&interrupts_gic, id, priority, trigger);
+	XScuGic_Enable(&interrupts_gic, id);
+	return XST_SUCCESS;
+}
+
+void interrupts_disconnect(u32 id){
+	if (!interrupts_ready)
+		return;
+
+	XScuGic_Disable(&interrupts_gic, id);
+	XScuGic_Disconnect(&interrupts_gic, id);
+}
@@ -0,0 +1,26 @@
+#ifndef INTERRUPTS_H
+#define INTERRUPTS_H
+
+#include "xil_types.h"
+#include "xil_exception.h"
+#include "xscugic.h"
+
+/*
+ * Shared GIC setup: the first connect initializes the GIC and enables IRQs,
+ * so modules that own a timer interrupt do not each configure the GIC.
+ * Handlers run in IRQ mode with IRQs masked (no nesting).
+ */
+
+//GIC priorities, lower is more urgent, in steps of 8
+#define INTERRUPTS_PRIORITY_HIGH   0x08
+#define INTERRUPTS_PRIORITY_NORMAL 0xA0
+#define INTERRUPTS_PRIORITY_LOW    0xF0
+
+extern XScuGic interrupts_gic;
+
+int interrupts_initialize();
+//connects the handler, sets its priority (rising edge for the private peripherals) and enables it
+int interrupts_connect(u32 id, Xil_InterruptHandler handler, void *ref, u8 priority);
+void interrupts_disconnect(u32 id);
+
+#endif //INTERRUPTS_H
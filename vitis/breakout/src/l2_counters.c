@@ -0,0 +1,162 @@
+#include "l2_counters.h"
+
+#include <string.h>
+#include "xl2cc_counter.h"
+#include "xtime_l.h"
+#include "xil_printf.h"
+#include "renderer.h"
+
+//events counted per phase, the pair index is the frame number modulo L2_PAIRS
+#define L2_EVENTS 6
+#define L2_PAIRS  (L2_EVENTS / 2)
+
+#define L2_READ_REQ   0
+#define L2_READ_HIT   1
+#define L2_WRITE_REQ  2
+#define L2_WRITE_HIT  3
+#define L2_CASTOUT    4
+#define L2_WRITE_ALLOC 5
+
+static const s32 l2_event_codes[L2_EVENTS] = {
+	XL2CC_DRREQ, XL2CC_DRHIT,
+	XL2CC_DWREQ, XL2CC_DWHIT,
+	XL2CC_CO,    XL2CC_WA
+};
+
+typedef struct {
+	u64 events[L2_EVENTS];
+	u32 samples[L2_EVENTS]; //frames each event was counted in
+	u64 time;               //global timer counts spent in the phase
+	u32 count;
+	XTime start;
+} l2_phase_s;
+
+static const char *l2_phase_names[L2_PHASES] = { "clear", "draw", "flush" };
+
+static l2_phase_s l2_phases[L2_PHASES];
+static int l2_enabled;
+static u32 l2_pair;
+static u32 l2_frames;
+static XTime l2_first_frame;
+static XTime l2_last_frame;
+
+void l2_counters_enable(int enable){
+	l2_enabled = enable;
+	l2_counters_reset();
+}
+
+void l2_counters_reset(){
+	memset(l2_phases, 0, sizeof(l2_phases));
+	l2_pair = 0;
+	l2_frames = 0;
+	XL2cc_EventCtrInit(l2_event_codes[0], l2_event_codes[1]);
+}
+
+void l2_counters_begin(l2_phase_e phase){
+	if (!l2_enabled)
+		return;
+
+	XTime_GetTime(&l2_phases[phase].start);
+	XL2cc_EventCtrStart();
+}
+
+void l2_counters_end(l2_phase_e phase){
+	l2_phase_s *p = &l2_phases[phase];
+	u32 counter0;
+	u32 counter1;
+	XTime now;
+
+	if (!l2_enabled)
+		return;
+
+	XL2cc_EventCtrStop(&counter0, &counter1);
+	XTime_GetTime(&now);
+
+	p->events[2 * l2_pair] += counter0;
+	p->events[2 * l2_pair + 1] += counter1;
+	p->samples[2 * l2_pair]++;
+	p->samples[2 * l2_pair + 1]++;
+	p->time += now - p->start;
+	p->count++;
+}
+
+void l2_counters_frame(){
+	if (!l2_enabled)
+		return;
+
+	XTime_GetTime(&l2_last_frame);
+	if (l2_frames == 0)
+		l2_first_frame = l2_last_frame;
+	l2_frames++;
+
+	if (++l2_pair == L2_PAIRS)
+		l2_pair = 0;
+	XL2cc_EventCtrInit(l2_event_codes[2 * l2_pair], l2_event_codes[2 * l2_pair + 1]);
+}
+
+//mean count of an event per frame
+static u32 l2_mean(const l2_phase_s *p, u32 event){
+	if (p->samples[event] == 0)
+		return 0;
+	return (u32)(p->events[event] / p->samples[event]);
+}
+
+void l2_counters_report(){
+	const VideoMode *mode = renderer_get_mode();
+	const l2_phase_s *p;
+	u32 fps_x100 = 0;
+	u32 read_kb;
+	u32 write_kb;
+	u32 total_read_kb = 0;
+	u32 total_write_kb = 0;
+	u32 phase_us;
+	u32 reads;
+	u32 fills;
+	u32 scanout_bytes;
+	u32 refresh_x100;
+	int i;
+
+	if (l2_frames > 1)
+		fps_x100 = (u32)((u64)(l2_frames - 1) * COUNTS_PER_SECOND * 100 / (l2_last_frame - l2_first_frame));
+
+	xil_printf("L2 (per frame)  rd_req  rd_hit  wr_req  wr_hit  castout  wr_alloc  ddr_rd_KB  ddr_wr_KB  rd_MB/s  wr_MB/s\n\r");
+	for (i = 0; i < L2_PHASES; i++){
+		p = &l2_phases[i];
+		if (p->count == 0)
+			continue;
+
+		//the pairs were counted in different frames, so the means can disagree slightly
+		reads = l2_mean(p, L2_READ_REQ);
+		fills = reads > l2_mean(p, L2_READ_HIT) ? reads - l2_mean(p, L2_READ_HIT) : 0;
+		fills += l2_mean(p, L2_WRITE_ALLOC);
+		read_kb = fills * L2_COUNTERS_LINE_BYTES / 1024;
+		write_kb = l2_mean(p, L2_CASTOUT) * L2_COUNTERS_LINE_BYTES / 1024;
+		phase_us = (u32)(p->time * 1000000 / COUNTS_PER_SECOND / p->count);
+
+		//MB/s while the phase runs, bytes per us is MB per second
+		xil_printf("%-14s %7d %7d %7d %7d %8d %9d %10d %10d %8d %8d\n\r",
+				l2_phase_names[i],
+				l2_mean(p, L2_READ_REQ), l2_mean(p, L2_READ_HIT),
+				l2_mean(p, L2_WRITE_REQ), l2_mean(p, L2_WRITE_HIT),
+				l2_mean(p, L2_CASTOUT), l2_mean(p, L2_WRITE_ALLOC),
+				read_kb, write_kb,
+				phase_us ? read_kb * 1024 / phase_us : 0,
+				phase_us ? write_kb * 1024 / phase_us : 0);
+		total_read_kb += read_kb;
+		total_write_kb += write_kb;
+	}
+
+	//sustained MB/s is the per frame traffic at the measured frame rate
+	xil_printf("CPU %d KB/frame rd, %d KB/frame wr, %d MB/s rd, %d MB/s wr over %d frames at %d.%02d fps\n\r",
+			total_read_kb, total_write_kb,
+			(u32)((u64)total_read_kb * 1024 * fps_x100 / 100000000),
+			(u32)((u64)total_write_kb * 1024 * fps_x100 / 100000000),
+			l2_frames, fps_x100 / 100, fps_x100 % 100);
+	//the mode the governor left the display in, hmax and vmax are the last pixel and line of the blanking
+	scanout_bytes = mode->width * mode->height * 3;
+	refresh_x100 = (u32)(mode->freq * 100000000.0 / ((mode->hmax + 1) * (mode->vmax + 1)));
+	xil_printf("VDMA %d KB/frame rd, %d MB/s rd at %dx%d %d.%02d Hz scanout\n\r",
+			scanout_bytes / 1024,
+			(u32)((u64)scanout_bytes * refresh_x100 / 100000000),
+			mode->width, mode->height, refresh_x100 / 100, refresh_x100 % 100);
+}
@@ -0,0 +1,39 @@
+#ifndef L2_COUNTERS_H
+#define L2_COUNTERS_H
+
+#include "xil_types.h"
+
+/*
+ * DDR traffic estimate per frame phase from the PL310 L2 event counters.
+ * The PL310 has only two counters, so each frame counts one pair of events
+ * and the pairs rotate every frame; the report averages each event over the
+ * frames it was counted in.
+ *
+ * DDR reads are L2 line fills (read misses and write allocations) and DDR
+ * writes are castouts, 32 bytes each. Lines cleaned by Xil_DCacheFlushRange
+ * are written without a castout, so the flush phase shows the L1 write-backs
+ * reaching L2 (write requests) rather than its DDR writes.
+ */
+
+#define L2_COUNTERS_LINE_BYTES 32
+
+typedef enum {
+	L2_PHASE_CLEAR = 0,
+	L2_PHASE_DRAW  = 1,
+	L2_PHASE_FLUSH = 2,
+	L2_PHASES
+} l2_phase_e;
+
+void l2_counters_enable(int enable);
+void l2_counters_reset();
+
+//phases must not nest, the counters are reset at every begin
+void l2_counters_begin(l2_phase_e phase);
+void l2_counters_end(l2_phase_e phase);
+//call once per frame, switches to the next event pair
+void l2_counters_frame();
+
+//also prints the VDMA scanout reads of the current video mode for comparison
+void l2_counters_report();
+
+#endif //L2_COUNTERS_H
@@ -0,0 +1,155 @@
+#include "latency.h"
+
+#include "xil_exception.h"
+#include "xil_printf.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "buttons.h"
+#include "input.h"
+#include "profiler.h"
+#include "renderer.h"
+
+#define LATENCY_BAR_WIDTH 50
+
+static int latency_ready;
+static u32 latency_last_buttons;
+
+//the press being measured, shared with the scanout interrupt
+static volatile int latency_in_flight;
+static XTime latency_press_time;
+static volatile u32 latency_tagged; //bit per frame buffer rendered since the press
+
+static u32 latency_histogram[LATENCY_BUCKETS];
+static u32 latency_measured;
+static u32 latency_sum_us;
+static u32 latency_min_us;
+static u32 latency_max_us;
+
+static void latency_scanout(u32 frame_index, XTime time){
+	u32 us, bucket;
+
+	if (!latency_in_flight || !(latency_tagged & (1 << frame_index)))
+		return;
+
+	us = (u32)(((time - latency_press_time) * PROFILER_US_PER_COUNT_Q32) >> 32);
+	bucket = us / LATENCY_BUCKET_US;
+	if (bucket >= LATENCY_BUCKETS)
+		bucket = LATENCY_BUCKETS - 1;
+	latency_histogram[bucket]++;
+	latency_measured++;
+	latency_sum_us += us;
+	if (us < latency_min_us)
+		latency_min_us = us;
+	if (us > latency_max_us)
+		latency_max_us = us;
+
+	latency_tagged = 0;
+	latency_in_flight = FALSE;
+}
+
+int latency_initialize(){
+	if (latency_ready)
+		return XST_SUCCESS;
+
+	latency_clear();
+	if (renderer_set_scanout_callback(latency_scanout) != XST_SUCCESS){
+		xil_printf("latency: no scanout interrupt\n\r");
+		return XST_FAILURE;
+	}
+	latency_ready = TRUE;
+	return XST_SUCCESS;
+}
+
+void latency_stop(){
+	if (!latency_ready)
+		return;
+
+	renderer_set_scanout_callback(NULL);
+	latency_in_flight = FALSE;
+	latency_ready = FALSE;
+}
+
+void latency_clear(){
+	int i;
+
+	Xil_ExceptionDisable();
+	for (i = 0; i < LATENCY_BUCKETS; i++)
+		latency_histogram[i] = 0;
+	latency_measured = 0;
+	latency_sum_us = 0;
+	latency_min_us = 0xFFFFFFFF;
+	latency_max_us = 0;
+	latency_tagged = 0;
+	latency_in_flight = FALSE;
+	Xil_ExceptionEnable();
+}
+
+void latency_input(u32 buttons){
+	u32 pressed = buttons & ~latency_last_buttons;
+
+	latency_last_buttons = buttons;
+	if (!latency_ready || !pressed || latency_in_flight)
+		return;
+
+	if (input_get_source() != INPUT_SOURCE_BUTTONS || !buttons_press_time(&latency_press_time))
+		XTime_GetTime(&latency_press_time);
+	latency_tagged = 0;
+	latency_in_flight = TRUE;
+}
+
+void latency_submit(int frame_index){
+	//if the press is shown between the check and the tag, the tag would start a stale measurement
+	Xil_ExceptionDisable();
+	if (latency_in_flight)
+		latency_tagged |= 1 << frame_index;
+	Xil_ExceptionEnable();
+}
+
+u32 latency_count(){
+	return latency_measured;
+}
+
+//upper edge of the bucket that holds the given percentile
+static u32 latency_percentile_us(u32 percent){
+	u32 target = (u32)(((u64)latency_measured * percent + 99) / 100);
+	u32 seen = 0;
+	int i;
+
+	for (i = 0; i < LATENCY_BUCKETS; i++){
+		seen += latency_histogram[i];
+		if (seen >= target)
+			return (i + 1) * LATENCY_BUCKET_US;
+	}
+	return LATENCY_BUCKETS * LATENCY_BUCKET_US;
+}
+
+void latency_report(){
+	u32 peak = 0;
+	int i, j, bar;
+
+	xil_printf("motion-to-photon latency: %d presses\n\r", latency_measured);
+	if (latency_measured == 0)
+		return;
+
+	xil_printf("  us: min %d | mean %d | p50 %d | p90 %d | p99 %d | max %d\n\r",
+			latency_min_us, latency_sum_us / latency_measured,
+			latency_percentile_us(50), latency_percentile_us(90),
+			latency_percentile_us(99), latency_max_us);
+
+	for (i = 0; i < LATENCY_BUCKETS; i++)
+		if (latency_histogram[i] > peak)
+			peak = latency_histogram[i];
+
+	for (i = 0; i < LATENCY_BUCKETS; i++){
+		if (!latency_histogram[i])
+			continue;
+		bar = (latency_histogram[i] * LATENCY_BAR_WIDTH + peak - 1) / peak;
+		if (i == LATENCY_BUCKETS - 1)
+			xil_printf("  >=%2d ms %5d ", i * LATENCY_BUCKET_US / 1000, latency_histogram[i]);
+		else
+			xil_printf("  %4d ms %5d ", i * LATENCY_BUCKET_US / 1000, latency_histogram[i]);
+		for (j = 0; j < bar; j++)
+			outbyte('#');
+		xil_printf("\n\r");
+	}
+}
@@ -0,0 +1,35 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "xil_types.h"
+
+/*
+ * Motion-to-photon latency: latency_input() stamps a new press with the time
+ * the button ISR saw it (see buttons.h), latency_submit() tags the frame
+ * buffers rendered after it, and the VDMA frame count interrupt (see
+ * renderer_set_scanout_callback) records the time from the press until the
+ * display has fetched the first tagged buffer. The paddle is in the bottom
+ * rows, so that is about when the player sees it move.
+ *
+ * One press is measured at a time, presses while one is in flight are skipped.
+ * With a source other than the buttons, the press is stamped when it is read.
+ */
+
+#define LATENCY_BUCKET_US 1000
+//the last bucket also holds everything longer
+#define LATENCY_BUCKETS   64
+
+int latency_initialize();
+void latency_stop();
+void latency_clear();
+
+//call with the frame's buttons, right after input_read_buttons()
+void latency_input(u32 buttons);
+//call with renderer_get_frame_index() just before renderer_render()
+void latency_submit(int frame_index);
+
+u32 latency_count();
+//prints min/percentiles/max and the histogram of the presses measured since the last clear
+void latency_report();
+
+#endif //LATENCY_H
@@ -59,6 +59,10 @@
 
 #include "renderer.h"
 #include "breakout_game.h"
+#include "renderer_bench.h"
+#include "ddr_bench.h"
+#include "cache_profile.h"
+#include "footprint.h"
 
 //microseconds per count (1 second = 1,000,000 microseconds)
 //COUNTS_PER_SECOND is 333,333,343 so us_per_count is around .003
@@ -116,6 +120,7 @@ int main() {
     xil_printf("\n\r==================== START ====================\n\r");
     xil_printf("Hello World\n\r");
     xil_printf("Successfully ran Hello World application\n\r");
+    footprint_report();
 
     //run timer test
 //    xil_printf("Running Timer Test\n\r");
@@ -124,8 +129,19 @@ int main() {
 //    xil_printf("Running Renderer Test\n\r");
 //    renderer_test();
 
+    //run the game logic headless to measure simulation throughput
+//    xil_printf("Running Headless Breakout\n\r");
+//    breakout_game_run_headless(1000000);
+
     xil_printf("Initializing Renderer\n\r");
     renderer_initialize();
+
+    //time the render paths before the game takes over the frame buffers
+//    renderer_bench_run(RENDERER_BENCH_DEFAULT_ITERATIONS);
+    //measure how much scanout in each video mode slows CPU frame writes
+//    ddr_bench_run(DDR_BENCH_DEFAULT_ITERATIONS);
+    //compare frame fill, copy and read bandwidth under each cache and prefetch profile
+//    cache_profile_bench(CACHE_PROFILE_BENCH_DEFAULT_ITERATIONS);
     xil_printf("\n\rRunning Breakout\n\r");
     breakout_game_run();
 
@@ -0,0 +1,135 @@
+#include "overlay.h"
+
+#include "renderer.h"
+#include "display_ctrl/display_ctrl.h"
+
+#define OVERLAY_BACKGROUND 30
+
+static const u8 overlay_colors[OVERLAY_MAX_ZONES][3] = {
+	{  0, 200,   0},
+	{  0, 120, 255},
+	{255, 140,   0},
+	{200,   0, 200},
+	{  0, 200, 200},
+	{200, 200, 200}
+};
+
+static profiler_s *overlay_zones[OVERLAY_MAX_ZONES];
+static int overlay_zone_count;
+static u32 overlay_budget_us;
+static int overlay_on;
+
+//bar heights in pixels per zone for the last OVERLAY_WIDTH frames
+static u8 overlay_history[OVERLAY_WIDTH][OVERLAY_MAX_ZONES];
+static u32 overlay_samples; //columns added since enabling
+//overlay_samples when each frame buffer was last drawn, -1 when it needs a full redraw
+static s32 overlay_drawn[DISPLAY_NUM_FRAMES];
+
+void overlay_initialize(profiler_s **zones, int count, u32 budget_us){
+	int i;
+
+	if (count > OVERLAY_MAX_ZONES)
+		count = OVERLAY_MAX_ZONES;
+	for (i = 0; i < count; i++)
+		overlay_zones[i] = zones[i];
+	overlay_zone_count = count;
+	overlay_budget_us = budget_us;
+}
+
+void overlay_enable(int enable){
+	int i;
+
+	overlay_on = enable;
+	overlay_samples = 0;
+	for (i = 0; i < DISPLAY_NUM_FRAMES; i++)
+		overlay_drawn[i] = -1;
+
+	if (enable)
+		renderer_set_clear_exclusion(OVERLAY_X, OVERLAY_Y, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+	else
+		renderer_set_clear_exclusion(0, 0, 0, 0);
+}
+
+int overlay_enabled(){
+	return overlay_on;
+}
+
+//the graph's position is in 1920x1080 pixels, in lower modes it would land in the playfield
+static int overlay_visible(){
+	const VideoMode *mode = renderer_get_mode();
+
+	return overlay_on && mode->width == 1920 && mode->height == 1080;
+}
+
+void overlay_sample(){
+	u8 *column;
+	u32 height;
+	int i;
+
+	if (!overlay_visible())
+		return;
+
+	column = overlay_history[overlay_samples % OVERLAY_WIDTH];
+	for (i = 0; i < overlay_zone_count; i++){
+		//OVERLAY_HEIGHT covers two budgets
+		height = overlay_zones[i]->elapsed_us * (OVERLAY_HEIGHT / 2) / overlay_budget_us;
+		column[i] = height > OVERLAY_HEIGHT ? OVERLAY_HEIGHT : height;
+	}
+	overlay_samples++;
+}
+
+//draws one column bottom up, sample < 0 draws it empty
+static void overlay_draw_column(u32 x, s32 sample){
+	u32 bottom = OVERLAY_Y + OVERLAY_HEIGHT - 1;
+	u32 budget_y = bottom - OVERLAY_HEIGHT / 2;
+	u32 y = bottom;
+	u32 top;
+	u8 *column;
+	int i;
+
+	if (sample >= 0){
+		column = overlay_history[sample % OVERLAY_WIDTH];
+		for (i = 0; i < overlay_zone_count && y >= OVERLAY_Y; i++){
+			top = column[i] > y - OVERLAY_Y + 1 ? OVERLAY_Y : y + 1 - column[i];
+			for (; y >= top; y--){
+				//the budget line stays visible across the bars
+				if (y == budget_y)
+					renderer_draw_pixel(x, y, 255, 255, 0);
+				else
+					renderer_draw_pixel(x, y, overlay_colors[i][0], overlay_colors[i][1], overlay_colors[i][2]);
+			}
+		}
+	}
+	for (; y >= OVERLAY_Y; y--){
+		if (y == budget_y)
+			renderer_draw_pixel(x, y, 255, 255, 0);
+		else
+			renderer_draw_pixel(x, y, OVERLAY_BACKGROUND, OVERLAY_BACKGROUND, OVERLAY_BACKGROUND);
+	}
+}
+
+void overlay_draw(){
+	int index = renderer_get_frame_index();
+	s32 newest = (s32)overlay_samples - 1;
+	s32 first;
+	s32 sample;
+	u32 x;
+
+	if (!overlay_visible())
+		return;
+
+	//a buffer that has fallen a whole graph behind is redrawn from the history
+	first = overlay_drawn[index] + 1;
+	if (overlay_drawn[index] < 0 || newest - first >= OVERLAY_WIDTH)
+		first = newest - OVERLAY_WIDTH + 1;
+
+	for (sample = first; sample <= newest; sample++){
+		//columns before the first sample are still empty
+		x = OVERLAY_X + (u32)(sample + OVERLAY_WIDTH) % OVERLAY_WIDTH;
+		overlay_draw_column(x, sample);
+	}
+
+	//the sweep cursor is the empty column after the newest one
+	overlay_draw_column(OVERLAY_X + (u32)(newest + 1) % OVERLAY_WIDTH, -1);
+	overlay_drawn[index] = newest;
+}
@@ -0,0 +1,33 @@
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include "xil_types.h"
+#include "profiler.h"
+
+/*
+ * Frame-time graph drawn in the left wall, outside the playfield: one column
+ * per frame, stacking the last elapsed time of each graphed profiler zone,
+ * with a line at the frame budget. A sweep cursor moves right instead of
+ * scrolling, and the area is excluded from the renderer's clear, so each
+ * frame buffer only needs the columns added since it was last drawn.
+ * The graph uses 1920x1080 pixels; in lower video modes overlay_sample and
+ * overlay_draw do nothing, and the graph starts over when 1920x1080 returns.
+ */
+
+#define OVERLAY_X      40
+#define OVERLAY_Y      820
+#define OVERLAY_WIDTH  400 //columns of history
+#define OVERLAY_HEIGHT 200 //twice the budget
+#define OVERLAY_MAX_ZONES 6
+
+//zones are stacked bottom up in the given order
+void overlay_initialize(profiler_s **zones, int count, u32 budget_us);
+void overlay_enable(int enable);
+int overlay_enabled();
+
+//adds a column from the zones' last elapsed times, call once per frame after they end
+void overlay_sample();
+//brings the current frame buffer up to date, call between drawing and renderer_render
+void overlay_draw();
+
+#endif //OVERLAY_H
@@ -0,0 +1,56 @@
+#include "placement.h"
+
+#include <string.h>
+#include "xil_cache.h"
+#include "xil_printf.h"
+
+//linker script symbols
+extern char __ocm_text_start[];
+extern char __ocm_text_end[];
+extern char __ocm_text_load[];
+extern char __ocm_data_start[];
+extern char __ocm_data_end[];
+extern char __ocm_data_load[];
+extern char __ocm_bss_start[];
+extern char __ocm_bss_end[];
+extern char _stack_end[];
+extern char __undef_stack[];
+
+//runs from DDR, nothing in OCM is valid yet
+void placement_initialize(){
+	u32 text_size = __ocm_text_end - __ocm_text_start;
+	u32 data_size = __ocm_data_end - __ocm_data_start;
+	u32 bss_size = __ocm_bss_end - __ocm_bss_start;
+
+	if (text_size != 0)
+		memcpy(__ocm_text_start, __ocm_text_load, text_size);
+	if (data_size != 0)
+		memcpy(__ocm_data_start, __ocm_data_load, data_size);
+	if (bss_size != 0)
+		memset(__ocm_bss_start, 0, bss_size);
+
+	//the copied code goes out through the data cache, the instruction side must not see stale lines
+	Xil_DCacheFlushRange((INTPTR)__ocm_text_start, __ocm_bss_end - __ocm_text_start);
+	Xil_ICacheInvalidate();
+}
+
+int placement_in_ocm_text(u32 addr){
+	return addr >= (u32)__ocm_text_start && addr < (u32)__ocm_text_end;
+}
+
+static void placement_print_region(const char *name, char *start, char *end){
+	xil_printf("  %-10s 0x%08x %6d bytes\n\r", name, (u32)start, (u32)(end - start));
+}
+
+void placement_report(){
+	u32 low = __ocm_bss_end - __ocm_text_start;
+	u32 high = __undef_stack - _stack_end;
+
+	xil_printf("placement:\n\r");
+	placement_print_region(".ocm_text", __ocm_text_start, __ocm_text_end);
+	placement_print_region(".ocm_data", __ocm_data_start, __ocm_data_end);
+	placement_print_region(".ocm_bss", __ocm_bss_start, __ocm_bss_end);
+	placement_print_region(".stack", _stack_end, __undef_stack);
+	xil_printf("  OCM low %d of %d bytes, OCM high %d of %d bytes\n\r",
+			low, PLACEMENT_OCM_LOW_BYTES, high, PLACEMENT_OCM_HIGH_BYTES);
+}
@@ -0,0 +1,35 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include "xil_types.h"
+
+/*
+ * On-chip memory placement: functions and data marked with the attributes
+ * below are linked to run from the low OCM bank (ps7_ram_0) instead of DDR,
+ * where they would queue behind the VDMA frame buffer streams. The stacks,
+ * and so every stack local such as the game's GameState, are in the high
+ * OCM bank (ps7_ram_1), see lscript.ld.
+ *
+ * The OCM sections are loaded into DDR with the rest of the image and
+ * placement_initialize() copies them over, so it has to run before any
+ * OCM_TEXT function is called or OCM_DATA is read.
+ * tools/placement_report.py lists what landed where in a built ELF.
+ */
+
+#define OCM_TEXT   __attribute__((section(".ocm_text")))
+#define OCM_RODATA __attribute__((section(".ocm_rodata")))
+#define OCM_DATA   __attribute__((section(".ocm_data")))
+//zeroed by placement_initialize(), not by the C start up code
+#define OCM_BSS    __attribute__((section(".ocm_bss")))
+
+//OCM bank sizes from the linker script's memory regions
+#define PLACEMENT_OCM_LOW_BYTES  0x30000
+#define PLACEMENT_OCM_HIGH_BYTES 0xFE00
+
+void placement_initialize();
+//TRUE when addr is in an OCM_TEXT function
+int placement_in_ocm_text(u32 addr);
+//prints the OCM sections and the stacks with their use of the banks
+void placement_report();
+
+#endif //PLACEMENT_H
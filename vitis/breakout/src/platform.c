@@ -34,6 +34,9 @@
 #include "xil_cache.h"
 
 #include "platform_config.h"
+#include "placement.h"
+#include "cache_profile.h"
+#include "footprint.h"
 
 /*
  * Uncomment one of the following two lines, depending on the target,
@@ -100,7 +103,12 @@ init_platform()
      */
     /* ps7_init();*/
     /* psu_init();*/
+    /* Copy the OCM sections in before anything placed there runs */
+    placement_initialize();
+    /* Before any interrupt can use the mode stacks */
+    footprint_paint_stacks();
     enable_caches();
+    cache_profile_apply(CACHE_PROFILE_DEFAULT);
     init_uart();
 }
 
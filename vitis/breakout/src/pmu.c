@@ -0,0 +1,41 @@
+#include "pmu.h"
+
+//PMCR bits
+#define PMU_PMCR_ENABLE       (1 << 0)
+#define PMU_PMCR_RESET_EVENTS (1 << 1)
+#define PMU_PMCR_RESET_CYCLES (1 << 2)
+
+//PMCNTENSET bit for the cycle counter
+#define PMU_CYCLE_COUNTER_BIT (1U << 31)
+
+static const u32 pmu_events[PMU_COUNTERS] = {
+	XPM_EVENT_INSTRRENAME, //the A9 has no instructions executed event, this counts them leaving rename
+	XPM_EVENT_DATA_CACHEREFILL,
+	XPM_EVENT_DATA_WRITE,
+	XPM_EVENT_BRANCHMISS,
+	XPM_EVENT_DATASTALL,
+	XPM_EVENT_INSTRSTALL
+};
+
+const char *pmu_event_names[PMU_COUNTERS] = {
+	"instr",
+	"l1d_refill",
+	"writes",
+	"br_miss",
+	"d_stall",
+	"i_stall"
+};
+
+void pmu_initialize(){
+	u32 i;
+
+	for (i = 0; i < PMU_COUNTERS; i++){
+		mtcp(XREG_CP15_EVENT_CNTR_SEL, i);
+		mtcp(XREG_CP15_EVENT_TYPE_SEL, pmu_events[i]);
+	}
+
+	mtcp(XREG_CP15_PERF_MONITOR_CTRL,
+			PMU_PMCR_ENABLE | PMU_PMCR_RESET_EVENTS | PMU_PMCR_RESET_CYCLES);
+	mtcp(XREG_CP15_COUNT_ENABLE_SET, PMU_CYCLE_COUNTER_BIT | ((1 << PMU_COUNTERS) - 1));
+	isb();
+}
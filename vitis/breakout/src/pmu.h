@@ -0,0 +1,46 @@
+#ifndef PMU_H
+#define PMU_H
+
+#include "xil_types.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xpm_counter.h"
+
+/*
+ * Cortex-A9 performance monitor: the cycle counter plus the 6 event counters,
+ * programmed with the events below. xpm_counter.c only offers fixed event
+ * sets, none of which has this combination, so the counters are set up here.
+ */
+
+#define PMU_COUNTERS XPM_CTRCOUNT
+
+//slot of each event in pmu_sample_s.events
+#define PMU_INSTRUCTIONS 0
+#define PMU_L1D_REFILLS  1
+#define PMU_DATA_WRITES  2
+#define PMU_BRANCH_MISS  3
+#define PMU_DATA_STALLS  4
+#define PMU_INSTR_STALLS 5
+
+typedef struct {
+	u32 cycles;
+	u32 events[PMU_COUNTERS];
+} pmu_sample_s;
+
+extern const char *pmu_event_names[PMU_COUNTERS];
+
+//programs the events and starts all counters from 0
+void pmu_initialize();
+
+//reads the cycle counter and all event counters, about 13 coprocessor accesses
+static inline void pmu_read(pmu_sample_s *sample){
+	u32 i;
+
+	sample->cycles = mfcp(XREG_CP15_PERF_CYCLE_COUNTER);
+	for (i = 0; i < PMU_COUNTERS; i++){
+		mtcp(XREG_CP15_EVENT_CNTR_SEL, i);
+		sample->events[i] = mfcp(XREG_CP15_PERF_MONITOR_COUNT);
+	}
+}
+
+#endif //PMU_H
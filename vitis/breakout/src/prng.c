@@ -0,0 +1,16 @@
+#include "prng.h"
+
+void prng_seed(prng_s *prng, u32 seed){
+	prng->state = seed ? seed : 1;
+}
+
+//xorshift32
+u32 prng_next(prng_s *prng){
+	u32 x = prng->state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	prng->state = x;
+	return x;
+}
@@ -0,0 +1,20 @@
+#ifndef PRNG_H
+#define PRNG_H
+
+#include "xil_types.h"
+
+/*
+ * Seeded xorshift32 used wherever a run has to be reproducible from a seed
+ * (random input, the autopilot). Each user keeps its own state, so one
+ * stream never shifts the other.
+ */
+
+typedef struct {
+	u32 state;
+} prng_s;
+
+//xorshift must never be seeded with 0, a 0 seed is replaced by 1
+void prng_seed(prng_s *prng, u32 seed);
+u32 prng_next(prng_s *prng);
+
+#endif //PRNG_H
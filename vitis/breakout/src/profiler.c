@@ -1,14 +1,297 @@
 #include "profiler.h"
 
+#include <string.h>
+#include "xil_printf.h"
+
+#define PROFILER_NAME_WIDTH 20
+
+static u32 profiler_window = PROFILER_MAX_WINDOW;
+static profiler_s *profiler_current; //innermost open zone
+static profiler_s *profiler_zones[PROFILER_MAX_ZONES];
+static int profiler_zone_count;
+static int profiler_pmu;
+
+static u32 profiler_bucket(u32 us){
+	u32 msb;
+	u32 bucket;
+
+	if (us < 8)
+		return us;
+
+	msb = 31 - __builtin_clz(us);
+	bucket = 8 + (msb - 3) * 4 + ((us >> (msb - 2)) & 3);
+	if (bucket >= PROFILER_BUCKETS)
+		bucket = PROFILER_BUCKETS - 1;
+	return bucket;
+}
+
+//smallest value that lands in the bucket
+static u32 profiler_bucket_floor(u32 bucket){
+	u32 msb;
+
+	if (bucket < 8)
+		return bucket;
+
+	msb = 3 + (bucket - 8) / 4;
+	return (4 + (bucket - 8) % 4) << (msb - 2);
+}
+
+static void profiler_reset_window(profiler_s *profiler){
+	profiler->window_next = 0;
+	profiler->window_count = 0;
+	profiler->window_size = profiler_window;
+	profiler->window_sum = 0;
+	memset(profiler->histogram, 0, sizeof(profiler->histogram));
+}
+
+//adds a sample to the rolling window, evicting the oldest one when it is full
+static void profiler_add_sample(profiler_s *profiler, u32 us){
+	u32 evicted;
+
+	//a zone filled under another window size would index past the new one
+	if (profiler->window_size != profiler_window)
+		profiler_reset_window(profiler);
+
+	if (profiler->window_count == profiler_window){
+		evicted = profiler->window[profiler->window_next];
+		profiler->window_sum -= evicted;
+		profiler->histogram[profiler_bucket(evicted)]--;
+	}
+	else {
+		profiler->window_count++;
+	}
+
+	profiler->window[profiler->window_next] = us;
+	profiler->window_sum += us;
+	profiler->histogram[profiler_bucket(us)]++;
+	profiler->total_count++;
+
+	if (++profiler->window_next == profiler_window)
+		profiler->window_next = 0;
+}
+
+void profiler_init(profiler_s *profiler, const char *name){
+	int i;
+
+	profiler_reset(profiler);
+	profiler->name = name;
+	profiler->trace_id = trace_register(name);
+
+	for (i = 0; i < profiler_zone_count; i++){
+		if (profiler_zones[i] == profiler)
+			return;
+	}
+	if (profiler_zone_count < PROFILER_MAX_ZONES)
+		profiler_zones[profiler_zone_count++] = profiler;
+}
+
 //stores the current cycle count from PMU into start
 void profiler_start(profiler_s *profiler){
+	profiler->parent = profiler_current;
+	profiler->depth = profiler_current ? profiler_current->depth + 1 : 0;
+	profiler_current = profiler;
+
+	if (profiler_pmu)
+		pmu_read(&profiler->pmu_start);
 	XTime_GetTime(&(profiler->start));
+	if (profiler->name)
+		trace_record(TRACE_BEGIN, profiler->trace_id, profiler->start, 0);
 }
 
 //stores the current cycle count from PMU into end
-//also calculates elapsed microseconds (elapsed_us)
+//also calculates elapsed microseconds (elapsed_us) and updates the statistics
 void profiler_end(profiler_s *profiler){
+	pmu_sample_s pmu_end;
+	u32 i;
+
 	XTime_GetTime(&(profiler->end));
+	if (profiler_pmu){
+		pmu_read(&pmu_end);
+		//u32 deltas stay correct across one wrap, ~6 seconds at 666 MHz
+		profiler->pmu_cycles += pmu_end.cycles - profiler->pmu_start.cycles;
+		for (i = 0; i < PMU_COUNTERS; i++)
+			profiler->pmu_events[i] += pmu_end.events[i] - profiler->pmu_start.events[i];
+		profiler->pmu_count++;
+	}
+	if (profiler->name)
+		trace_record(TRACE_END, profiler->trace_id, profiler->end, 0);
 	profiler->time_diff = profiler->end - profiler->start;
-	profiler->elapsed_us = (u32)(PROFILER_US_PER_COUNT * profiler->time_diff);
+	profiler->elapsed_us = (u32)((profiler->time_diff * PROFILER_US_PER_COUNT_Q32) >> 32);
+
+	profiler_add_sample(profiler, profiler->elapsed_us);
+
+	if (profiler_current == profiler)
+		profiler_current = profiler->parent;
+}
+
+void profiler_reset(profiler_s *profiler){
+	profiler_reset_window(profiler);
+	profiler->total_count = 0;
+	profiler->pmu_cycles = 0;
+	memset(profiler->pmu_events, 0, sizeof(profiler->pmu_events));
+	profiler->pmu_count = 0;
+}
+
+profiler_s *profiler_get_current(){
+	return profiler_current;
+}
+
+void profiler_set_window(u32 samples){
+	int i;
+
+	if (samples < 1)
+		samples = 1;
+	if (samples > PROFILER_MAX_WINDOW)
+		samples = PROFILER_MAX_WINDOW;
+
+	profiler_window = samples;
+	for (i = 0; i < profiler_zone_count; i++)
+		profiler_reset(profiler_zones[i]);
+}
+
+u32 profiler_get_window(){
+	return profiler_window;
+}
+
+static u32 profiler_percentile(const profiler_s *profiler, u32 percent){
+	u32 target = (profiler->window_count * percent + 99) / 100;
+	u32 seen = 0;
+	u32 i;
+
+	for (i = 0; i < PROFILER_BUCKETS; i++){
+		seen += profiler->histogram[i];
+		if (seen >= target)
+			return profiler_bucket_floor(i + 1) - 1;
+	}
+	return profiler_bucket_floor(PROFILER_BUCKETS - 1);
+}
+
+void profiler_get_stats(const profiler_s *profiler, profiler_stats_s *stats){
+	u32 i;
+
+	memset(stats, 0, sizeof(*stats));
+	stats->count = profiler->window_count;
+	if (stats->count == 0)
+		return;
+
+	stats->last = profiler->elapsed_us;
+	stats->min = 0xFFFFFFFF;
+	for (i = 0; i < profiler->window_count; i++){
+		if (profiler->window[i] < stats->min)
+			stats->min = profiler->window[i];
+		if (profiler->window[i] > stats->max)
+			stats->max = profiler->window[i];
+	}
+	stats->mean = (u32)(profiler->window_sum / profiler->window_count);
+	//a bucket edge can overshoot the largest sample in it
+	stats->p50 = profiler_percentile(profiler, 50);
+	if (stats->p50 > stats->max)
+		stats->p50 = stats->max;
+	stats->p99 = profiler_percentile(profiler, 99);
+	if (stats->p99 > stats->max)
+		stats->p99 = stats->max;
+}
+
+//xil_printf has no variable field width, so the name column is padded by hand
+static void profiler_print_name(const profiler_s *profiler){
+	const char *name = profiler->name ? profiler->name : "?";
+	int column = 2 * profiler->depth;
+	u32 d;
+
+	for (d = 0; d < profiler->depth; d++)
+		xil_printf("  ");
+	xil_printf("%s", name);
+	column += strlen(name);
+	for (; column < PROFILER_NAME_WIDTH; column++)
+		outbyte(' ');
+}
+
+void profiler_report(profiler_s *zones, int count){
+	profiler_stats_s stats;
+	int i;
+
+	for (i = 0; i < count; i++){
+		profiler_get_stats(&zones[i], &stats);
+		profiler_print_name(&zones[i]);
+		xil_printf(" %7d %7d %7d %7d %7d %7d  (%d)\n\r",
+				stats.last, stats.min, stats.mean,
+				stats.p50, stats.p99, stats.max, stats.count);
+	}
+}
+
+void profiler_report_header(){
+	int column;
+
+	xil_printf("zone (us)");
+	for (column = 9; column < PROFILER_NAME_WIDTH; column++)
+		outbyte(' ');
+	xil_printf("    last     min    mean     p50     p99     max  (n)\n\r");
+}
+
+void profiler_report_all(){
+	int i;
+
+	profiler_report_header();
+	for (i = 0; i < profiler_zone_count; i++)
+		profiler_report(profiler_zones[i], 1);
+}
+
+void profiler_enable_pmu(int enable){
+	int i;
+
+	if (enable && !profiler_pmu)
+		pmu_initialize();
+	profiler_pmu = enable;
+
+	//a zone that is open right now would otherwise end with a stale start
+	for (i = 0; i < profiler_zone_count; i++)
+		profiler_reset(profiler_zones[i]);
+}
+
+void profiler_report_pmu_header(){
+	int column;
+	u32 i;
+
+	xil_printf("zone (per sample)");
+	for (column = 17; column < PROFILER_NAME_WIDTH; column++)
+		outbyte(' ');
+	xil_printf("     cycles");
+	for (i = 0; i < PMU_COUNTERS; i++)
+		xil_printf(" %10s", pmu_event_names[i]);
+	xil_printf(" ipc%% stall%%\n\r");
+}
+
+void profiler_report_pmu(profiler_s *zones, int count){
+	profiler_s *zone;
+	u64 stalls;
+	int i;
+	u32 e;
+
+	for (i = 0; i < count; i++){
+		zone = &zones[i];
+		profiler_print_name(zone);
+		if (zone->pmu_count == 0 || zone->pmu_cycles == 0){
+			xil_printf("          -\n\r");
+			continue;
+		}
+
+		xil_printf(" %10d", (u32)(zone->pmu_cycles / zone->pmu_count));
+		for (e = 0; e < PMU_COUNTERS; e++)
+			xil_printf(" %10d", (u32)(zone->pmu_events[e] / zone->pmu_count));
+		//the two stall events can overlap, so stall% is an upper bound
+		stalls = zone->pmu_events[PMU_DATA_STALLS] + zone->pmu_events[PMU_INSTR_STALLS];
+		if (stalls > zone->pmu_cycles)
+			stalls = zone->pmu_cycles;
+		xil_printf(" %4d %6d\n\r",
+				(u32)(zone->pmu_events[PMU_INSTRUCTIONS] * 100 / zone->pmu_cycles),
+				(u32)(stalls * 100 / zone->pmu_cycles));
+	}
+}
+
+void profiler_report_pmu_all(){
+	int i;
+
+	profiler_report_pmu_header();
+	for (i = 0; i < profiler_zone_count; i++)
+		profiler_report_pmu(profiler_zones[i], 1);
 }
@@ -2,17 +2,88 @@
 #define PROFILER_H
 
 #include "xtime_l.h"
+#include "trace.h"
+#include "pmu.h"
 
-#define PROFILER_US_PER_COUNT (1000000.0 / COUNTS_PER_SECOND)
+/*
+ * Microseconds per global timer count as a Q32 fixed-point multiplier,
+ * so converting a cycle delta is one integer multiply and shift
+ */
+#define PROFILER_US_PER_COUNT_Q32 ((u64)((1000000ULL << 32) / COUNTS_PER_SECOND))
 
-typedef struct {
+//most samples a zone keeps for its rolling statistics
+#define PROFILER_MAX_WINDOW 256
+//zones that profiler_init registers for profiler_report_all
+#define PROFILER_MAX_ZONES 32
+/*
+ * Log-linear histogram buckets: exact below 8 us, then 4 buckets per
+ * power of two (about 25% wide) up to ~16 seconds
+ */
+#define PROFILER_BUCKETS 96
+
+typedef struct profiler_s {
 	XTime start;
 	XTime end;
 	XTime time_diff;
 	u32 elapsed_us;
+
+	const char *name;
+	struct profiler_s *parent; //zone that was open when this one started
+	u32 depth;                 //number of enclosing zones
+	u16 trace_id;              //only named zones emit trace events
+
+	//rolling window of the last profiler_get_window() samples, in us
+	u32 window[PROFILER_MAX_WINDOW];
+	u32 window_next;
+	u32 window_count;
+	u32 window_size; //profiler_get_window() when the window was last emptied
+	u64 window_sum;
+	u16 histogram[PROFILER_BUCKETS];
+	u32 total_count; //samples since the last reset
+
+	//PMU deltas summed since the last reset, only while profiler_enable_pmu is on
+	pmu_sample_s pmu_start;
+	u64 pmu_cycles;
+	u64 pmu_events[PMU_COUNTERS];
+	u32 pmu_count;
 } profiler_s;
 
+typedef struct {
+	u32 count; //samples in the window
+	u32 last;
+	u32 min;
+	u32 max;
+	u32 mean;
+	u32 p50; //percentiles are the upper edge of their histogram bucket
+	u32 p99;
+} profiler_stats_s;
+
+//names the zone and registers it for profiler_report_all, zones work without it too
+void profiler_init(profiler_s*, const char *name);
 void profiler_start(profiler_s*);
 void profiler_end(profiler_s*);
+void profiler_reset(profiler_s*);
+//innermost zone that is open right now, NULL outside all zones
+profiler_s *profiler_get_current();
+
+/*
+ * Changes the window (clamped to PROFILER_MAX_WINDOW) and resets every
+ * registered zone. Unregistered zones empty their window at their next sample.
+ */
+void profiler_set_window(u32 samples);
+u32 profiler_get_window();
+
+void profiler_get_stats(const profiler_s*, profiler_stats_s *stats);
+//one line per zone, indented by nesting depth
+void profiler_report_header();
+void profiler_report(profiler_s *zones, int count);
+void profiler_report_all();
+
+//captures PMU counters in every zone start/end, costs ~30 coprocessor reads per zone
+void profiler_enable_pmu(int enable);
+//mean cycles and events per sample, with IPC and stall share in percent
+void profiler_report_pmu_header();
+void profiler_report_pmu(profiler_s *zones, int count);
+void profiler_report_pmu_all();
 
 #endif //PROFILER_H
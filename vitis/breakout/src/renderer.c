@@ -12,6 +12,10 @@
 
 #include "display_ctrl/display_ctrl.h"
 #include "profiler.h"
+#include "l2_counters.h"
+#include "interrupts.h"
+#include "placement.h"
+#include "arena.h"
 
 #define DEMO_PATTERN_0 0
 #define DEMO_PATTERN_1 1
@@ -27,10 +31,14 @@
 #define HDMI_IN_GPIO_IRPT_ID 	XPAR_FABRIC_AXI_GPIO_VIDEO_IP2INTC_IRPT_INTR
 #define SCU_TIMER_ID 			XPAR_SCUTIMER_DEVICE_ID
 #define UART_BASEADDR 			XPAR_PS7_UART_1_BASEADDR
+#define VDMA_MM2S_IRPT_ID 		XPAR_FABRIC_AXIVDMA_0_MM2S_INTROUT_VEC_ID
 
 DisplayCtrl dispCtrl;
 XAxiVdma vdma;
 profiler_s profiler_renderer[10];
+//phases of renderer_render, nested in whatever zone the caller has open
+profiler_s profiler_flush;
+profiler_s profiler_clear;
 
 //Framebuffers for video data
 u8 frameBuf[DISPLAY_NUM_FRAMES][RENDERER_MAX_FRAME] __attribute__((aligned(0x20)));
@@ -43,6 +51,16 @@ u8 *pFrames[DISPLAY_NUM_FRAMES]; //array of pointers to the frame buffers
  * 		(frame 0 should not be touched)
  */
 int current_frame_index;
+//frames 1 to buffer_count are drawn in turn
+static int buffer_count = DISPLAY_NUM_FRAMES - 1;
+
+//rectangle that renderer_render does not clear, in pixels (width 0 when unused)
+static u32 clear_exclusion_x;
+static u32 clear_exclusion_y;
+static u32 clear_exclusion_width;
+static u32 clear_exclusion_height;
+
+static renderer_scanout_callback scanout_callback;
 
 void DemoPrintTest(u8 *frame, u32 width, u32 height, u32 stride, int pattern);
 
@@ -57,6 +75,8 @@ void renderer_initialize(){
 	int i;
 
 	xil_printf("Initializing Renderer\n\r");
+	profiler_init(&profiler_flush, "flush");
+	profiler_init(&profiler_clear, "clear");
 	/*
 	 * Initialize an array of pointers to the 3 frame buffers
 	 */
@@ -125,7 +145,7 @@ void renderer_initialize(){
 	xil_printf("Initialization Complete!\n\r\n\r");
 }
 
-void renderer_draw_pixel(u32 x, u32 y, u8 r, u8 g, u8 b){
+OCM_TEXT void renderer_draw_pixel(u32 x, u32 y, u8 r, u8 g, u8 b){
 	u32 pixel_address;
 	u8 *frame = pFrames[current_frame_index];
 
@@ -145,35 +165,207 @@ void renderer_draw_pixel(u32 x, u32 y, u8 r, u8 g, u8 b){
 }
 
 //much faster than drawing each pixel individually but the color must be greyscale
-void renderer_draw_grey_row(u32 x, u32 y, u32 width, u8 grey){
+OCM_TEXT void renderer_draw_grey_row(u32 x, u32 y, u32 width, u8 grey){
 	u8 *frame = pFrames[current_frame_index];
 	memset(frame + x*3 + RENDERER_STRIDE*y, grey, 3*width*sizeof(u8));
 }
 
+void renderer_set_clear_exclusion(u32 x, u32 y, u32 width, u32 height){
+	if (width == 0 || height == 0){
+		clear_exclusion_width = 0;
+		return;
+	}
+	clear_exclusion_x = x;
+	clear_exclusion_y = y;
+	clear_exclusion_width = width;
+	clear_exclusion_height = height;
+}
+
+int renderer_get_frame_index(){
+	return current_frame_index;
+}
+
+int renderer_set_buffer_count(int count){
+	if (count < 2 || count > DISPLAY_NUM_FRAMES - 1)
+		return XST_FAILURE;
+	//takes effect when renderer_render next advances the frame
+	buffer_count = count;
+	return XST_SUCCESS;
+}
+
+int renderer_get_buffer_count(){
+	return buffer_count;
+}
+
+u8 *renderer_get_frame_buffer(int index){
+	return pFrames[index];
+}
+
+int renderer_stop_display(){
+	return DisplayStop(&dispCtrl);
+}
+
+int renderer_set_mode(const VideoMode *mode){
+	int Status;
+
+	Status = DisplaySetMode(&dispCtrl, mode);
+	if (Status != XST_SUCCESS)
+		return Status;
+	Status = DisplayStart(&dispCtrl);
+	if (Status != XST_SUCCESS)
+		return Status;
+
+	//restarting the read channel may drop the frame count setup
+	if (scanout_callback)
+		return renderer_set_scanout_callback(scanout_callback);
+	return XST_SUCCESS;
+}
+
+const VideoMode *renderer_get_mode(){
+	return &dispCtrl.vMode;
+}
+
+//VDMA frame count interrupt, the read channel has just fetched the last line of a frame
+static void renderer_scanout_done(void *ref, u32 types){
+	XTime now;
+
+	XTime_GetTime(&now);
+	//the frame store still points at the frame that was just read until the next frame sync
+	if (scanout_callback)
+		scanout_callback(XAxiVdma_CurrFrameStore(&vdma, XAXIVDMA_READ), now);
+}
+
+//the error interrupt is not enabled, the driver calls this for spurious interrupts
+static void renderer_scanout_error(void *ref, u32 mask){
+}
+
+int renderer_set_scanout_callback(renderer_scanout_callback callback){
+	XAxiVdma_FrameCounter counter = {1, 0, 1, 0};
+	int Status;
+
+	if (!callback){
+		XAxiVdma_IntrDisable(&vdma, XAXIVDMA_IXR_FRMCNT_MASK, XAXIVDMA_READ);
+		interrupts_disconnect(VDMA_MM2S_IRPT_ID);
+		scanout_callback = NULL;
+		return XST_SUCCESS;
+	}
+
+	scanout_callback = callback;
+	XAxiVdma_SetCallBack(&vdma, XAXIVDMA_HANDLER_GENERAL, renderer_scanout_done, NULL, XAXIVDMA_READ);
+	XAxiVdma_SetCallBack(&vdma, XAXIVDMA_HANDLER_ERROR, renderer_scanout_error, NULL, XAXIVDMA_READ);
+
+	//interrupt after every frame
+	Status = XAxiVdma_SetFrameCounter(&vdma, &counter);
+	if (Status != XST_SUCCESS){
+		xil_printf("Setting the VDMA frame counter failed %d\r\n", Status);
+		return Status;
+	}
+
+	Status = interrupts_connect(VDMA_MM2S_IRPT_ID, XAxiVdma_ReadIntrHandler, &vdma, INTERRUPTS_PRIORITY_NORMAL);
+	if (Status != XST_SUCCESS)
+		return Status;
+	XAxiVdma_IntrEnable(&vdma, XAXIVDMA_IXR_FRMCNT_MASK, XAXIVDMA_READ);
+	return XST_SUCCESS;
+}
+
+u32 renderer_take_scanout_errors(){
+	u32 errors = XAxiVdma_GetDmaChannelErrors(&vdma, XAXIVDMA_READ);
+
+	if (errors)
+		XAxiVdma_ClearDmaChannelErrors(&vdma, XAXIVDMA_READ, errors);
+	return errors;
+}
+
+//clears everything but the exclusion rectangle with one memset per row it spans
+OCM_TEXT static void renderer_clear_around_exclusion(u8 *frame, u8 grey, u32 end){
+	u32 gap = clear_exclusion_width * 3;
+	u32 last_row = clear_exclusion_y + clear_exclusion_height - 1;
+	u32 from;
+	u32 row;
+
+	//up to the exclusion on its first row
+	memset(frame, grey, RENDERER_STRIDE * clear_exclusion_y + clear_exclusion_x * 3);
+	//from the end of the exclusion on one row to its start on the next
+	for (row = clear_exclusion_y; row < last_row; row++){
+		from = RENDERER_STRIDE * row + clear_exclusion_x * 3 + gap;
+		memset(frame + from, grey, RENDERER_STRIDE - gap);
+	}
+	from = RENDERER_STRIDE * last_row + clear_exclusion_x * 3 + gap;
+	memset(frame + from, grey, end - from);
+}
+
+/*
+ * Clears the active area of the current video mode. Narrower modes clear
+ * each row up to the mode's width, since the rest of the stride is never
+ * scanned out. The exclusion only applies when it lies inside the area.
+ */
+OCM_TEXT static void renderer_clear(u8 *frame, u8 grey){
+	u32 width = dispCtrl.vMode.width;
+	u32 height = dispCtrl.vMode.height;
+	int excluded = clear_exclusion_width &&
+			clear_exclusion_y + clear_exclusion_height <= height &&
+			clear_exclusion_x + clear_exclusion_width <= width;
+	u8 *row_start;
+	u32 row;
+
+	if (width * 3 >= RENDERER_STRIDE){
+		if (excluded)
+			renderer_clear_around_exclusion(frame, grey, RENDERER_STRIDE * height);
+		else
+			memset(frame, grey, RENDERER_STRIDE * height);
+		return;
+	}
+
+	for (row = 0; row < height; row++){
+		row_start = frame + RENDERER_STRIDE * row;
+		if (excluded && row >= clear_exclusion_y && row < clear_exclusion_y + clear_exclusion_height){
+			memset(row_start, grey, clear_exclusion_x * 3);
+			row_start += (clear_exclusion_x + clear_exclusion_width) * 3;
+			memset(row_start, grey, (width - clear_exclusion_x - clear_exclusion_width) * 3);
+		}
+		else {
+			memset(row_start, grey, width * 3);
+		}
+	}
+}
+
 /*
  * 1. Flushes the cache for the current frame causing the dirty pixels to be written to the VDMA
  * 2. Sets Display Control's frame to current frame
  * 3. Advances the current frame to the next one
  * 4. Clears the new current frame by setting every pixel to a greyscale color
  */
-void renderer_render(u8 grey){
+OCM_TEXT void renderer_render(u8 grey){
 	u8 *current_frame;
 
 	current_frame = pFrames[current_frame_index];
 
 	//flush the cache which somehow writes to the DMA
-	Xil_DCacheFlushRange((unsigned int)current_frame, RENDERER_MAX_FRAME);
+	profiler_start(&profiler_flush);
+	l2_counters_begin(L2_PHASE_FLUSH);
+	//only the rows of the current video mode are scanned out
+	Xil_DCacheFlushRange((unsigned int)current_frame, RENDERER_STRIDE * dispCtrl.vMode.height);
+	l2_counters_end(L2_PHASE_FLUSH);
+	profiler_end(&profiler_flush);
 	//advance Display Controller to current frame
 	DisplayChangeFrame(&dispCtrl, current_frame_index);
 
 	//advance current frame to next one
 	++current_frame_index;
-	if (current_frame_index == DISPLAY_NUM_FRAMES)
+	if (current_frame_index > buffer_count)
 		current_frame_index = 1;
 
 	//wipe the new current frame by setting all pixels to the same greyscale color
 	current_frame = pFrames[current_frame_index];
-	memset(current_frame, grey, RENDERER_MAX_FRAME * sizeof(u8));
+	profiler_start(&profiler_clear);
+	l2_counters_begin(L2_PHASE_CLEAR);
+	renderer_clear(current_frame, grey);
+	l2_counters_end(L2_PHASE_CLEAR);
+	profiler_end(&profiler_clear);
+	l2_counters_frame();
+
+	//the frame is handed to the display, nothing taken from the frame arena for it is needed any more
+	arena_reset(arena_frame());
 }
 
 void renderer_oscillate_test(){
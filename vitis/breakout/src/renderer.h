@@ -2,6 +2,8 @@
 #define RENDERER_H
 
 #include "xil_types.h"
+#include "xtime_l.h"
+#include "display_ctrl/vga_modes.h"
 
 #define RENDERER_MAX_FRAME (1920*1080*3)
 #define RENDERER_STRIDE (1920*3)
@@ -22,9 +24,44 @@ void renderer_draw_grey_row(u32 x, u32 y, u32 width, u8 grey);
  * 2. Sets Display Control's frame to current frame
  * 3. Advances the current frame to the next one
  * 4. Clears the new current frame by setting every pixel to a greyscale color
+ * 5. Resets the frame arena (see arena.h)
+ * The flush and clear only cover the width and height of the current video mode.
  */
 void renderer_render(u8 grey);
 
+/*
+ * Pixels inside the rectangle are skipped by the clear in renderer_render, so
+ * whatever is drawn there stays in that frame buffer until it is drawn over.
+ * A width or height of 0 turns the exclusion off.
+ */
+void renderer_set_clear_exclusion(u32 x, u32 y, u32 width, u32 height);
+//index of the frame buffer being drawn, in [1:renderer_get_buffer_count()]
+int renderer_get_frame_index();
+/*
+ * Number of frame buffers drawn in turn, from 2 (double buffering) up to
+ * DISPLAY_NUM_FRAMES - 1 (the default). Frame 0 is never drawn.
+ */
+int renderer_set_buffer_count(int count);
+int renderer_get_buffer_count();
+//start of a frame buffer's pixels, for code that fills or copies whole frames
+u8 *renderer_get_frame_buffer(int index);
+
+//stops scanout, returns once the VDMA read channel is idle
+int renderer_stop_display();
+//restarts scanout in the given mode (the frame buffers keep their 1920 pixel stride)
+int renderer_set_mode(const VideoMode *mode);
+const VideoMode *renderer_get_mode();
+//returns the VDMA read channel error bits (XAXIVDMA_SR_ERR_*) and clears them
+u32 renderer_take_scanout_errors();
+
+/*
+ * Called from the VDMA frame count interrupt each time the display has
+ * fetched a whole frame, with the index of that frame buffer and the time.
+ */
+typedef void (*renderer_scanout_callback)(u32 frame_index, XTime time);
+//NULL turns the interrupt off
+int renderer_set_scanout_callback(renderer_scanout_callback callback);
+
 void renderer_oscillate_test();
 void renderer_moving_box_test();
 
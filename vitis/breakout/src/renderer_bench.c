@@ -0,0 +1,181 @@
+#include "renderer_bench.h"
+
+#include <string.h>
+#include "xil_cache.h"
+#include "xil_printf.h"
+#include "xtime_l.h"
+#include "xstatus.h"
+
+#include "renderer.h"
+#include "breakout_game.h"
+#include "profiler.h"
+#include "dma.h"
+#include "display_ctrl/display_ctrl.h"
+
+#define BENCH_WIDTH  1920
+#define BENCH_HEIGHT 1080
+#define BENCH_PIXELS (BENCH_WIDTH * BENCH_HEIGHT)
+//four ball radii, a literal so the case label can be built from it
+#define BENCH_CIRCLE_RADIUS 28
+#define BENCH_STRING(x)     #x
+#define BENCH_LABEL(prefix, x) prefix BENCH_STRING(x)
+
+typedef char bench_circle_radius_matches[(BENCH_CIRCLE_RADIUS == BALL_RADIUS * 4) ? 1 : -1];
+
+//what one pass of a case does, arg selects a size where the case has several
+typedef void (*bench_fn)(u32 arg);
+
+typedef struct {
+	const char *name;
+	bench_fn fn;
+	u32 arg;
+	u32 bytes;  //bytes written or copied per pass
+	u32 pixels; //pixels per pass, 0 when it is not a pixel path
+} bench_case_s;
+
+static u8 *bench_frame;
+static u8 *bench_other; //second buffer for the copies
+
+static void bench_pixels(u32 arg){
+	u32 x;
+	u32 y;
+
+	for (y = 0; y < BENCH_HEIGHT; y++)
+		for (x = 0; x < BENCH_WIDTH; x++)
+			renderer_draw_pixel(x, y, x, y, arg);
+}
+
+static void bench_grey_rows(u32 arg){
+	u32 y;
+
+	for (y = 0; y < BENCH_HEIGHT; y++)
+		renderer_draw_grey_row(0, y, BENCH_WIDTH, arg);
+}
+
+static void bench_memset(u32 arg){
+	memset(bench_frame, arg, RENDERER_MAX_FRAME);
+}
+
+static void bench_flush(u32 bytes){
+	Xil_DCacheFlushRange((INTPTR)bench_frame, bytes);
+}
+
+static void bench_memcpy(u32 arg){
+	memcpy(bench_other, bench_frame, RENDERER_MAX_FRAME);
+}
+
+static void bench_dma(u32 arg){
+	if (dma_copy_start(bench_other, bench_frame, RENDERER_MAX_FRAME) == XST_SUCCESS)
+		dma_copy_wait();
+}
+
+static void bench_rect(u32 size){
+	draw_rect(100, 100, size, size, 255, 0, 0);
+}
+
+static void bench_circle(u32 radius){
+	draw_filled_circle(600, 540, radius, 255, 255, 255);
+}
+
+//dirties the range untimed before each flush pass, so the flush writes back every line
+static void bench_before_flush(u32 bytes){
+	memset(bench_frame, 0x55, bytes);
+}
+
+//area of the filled circle, counted the way draw_filled_circle tests pixels
+static u32 bench_circle_pixels(int radius){
+	u32 pixels = 0;
+	int x;
+	int y;
+
+	for (y = -radius; y <= radius; y++)
+		for (x = -radius; x <= radius; x++)
+			pixels += x * x + y * y <= radius * radius;
+	return pixels;
+}
+
+static void bench_print_name(const char *name){
+	int column = strlen(name);
+
+	xil_printf("%s", name);
+	for (; column < 18; column++)
+		outbyte(' ');
+}
+
+static void bench_run_case(const bench_case_s *c, u32 iterations){
+	XTime start;
+	XTime end;
+	u64 total = 0;
+	u64 best = ~0ULL;
+	u32 mean_us;
+	u32 best_us;
+	u32 mean_ns;
+	u32 i;
+
+	//the first pass warms the caches and TLB and is not counted
+	for (i = 0; i <= iterations; i++){
+		if (c->fn == bench_flush)
+			bench_before_flush(c->arg);
+
+		XTime_GetTime(&start);
+		c->fn(c->arg);
+		XTime_GetTime(&end);
+
+		if (i == 0)
+			continue;
+		total += end - start;
+		if (end - start < best)
+			best = end - start;
+	}
+
+	mean_ns = (u32)(total * 1000000000ULL / COUNTS_PER_SECOND / iterations);
+	mean_us = mean_ns / 1000;
+	best_us = (u32)((best * PROFILER_US_PER_COUNT_Q32) >> 32);
+
+	bench_print_name(c->name);
+	xil_printf(" %9d %8d %8d %7d",
+			c->bytes, mean_us, best_us,
+			mean_ns ? (u32)((u64)c->bytes * 1000 / mean_ns) : 0);
+	if (c->pixels)
+		//tenths of a ns
+		xil_printf(" %5d.%d\n\r",
+				(u32)((u64)mean_ns * 10 / c->pixels) / 10,
+				(u32)((u64)mean_ns * 10 / c->pixels) % 10);
+	else
+		xil_printf("       -\n\r");
+}
+
+void renderer_bench_run(u32 iterations){
+	u32 circle_pixels = bench_circle_pixels(BENCH_CIRCLE_RADIUS);
+	int index = renderer_get_frame_index();
+	bench_case_s cases[] = {
+		{"draw_pixel",      bench_pixels,    0,   RENDERER_MAX_FRAME, BENCH_PIXELS},
+		{"draw_grey_row",   bench_grey_rows, 100, RENDERER_MAX_FRAME, BENCH_PIXELS},
+		{"memset frame",    bench_memset,    100, RENDERER_MAX_FRAME, BENCH_PIXELS},
+		{"flush 4 KB",      bench_flush,     4 << 10,  4 << 10,  0},
+		{"flush 64 KB",     bench_flush,     64 << 10, 64 << 10, 0},
+		{"flush 512 KB",    bench_flush,     512 << 10, 512 << 10, 0},
+		{"flush 2 MB",      bench_flush,     2 << 20,  2 << 20,  0},
+		{"flush frame",     bench_flush,     RENDERER_MAX_FRAME, RENDERER_MAX_FRAME, 0},
+		{"memcpy frame",    bench_memcpy,    0,   RENDERER_MAX_FRAME, BENCH_PIXELS},
+		{"pl330 copy frame", bench_dma,      0,   RENDERER_MAX_FRAME, BENCH_PIXELS},
+		{"rect 100x100",    bench_rect,      100, 100 * 100 * 3, 100 * 100},
+		{"rect 400x400",    bench_rect,      400, 400 * 400 * 3, 400 * 400},
+		{BENCH_LABEL("circle r=", BENCH_CIRCLE_RADIUS), bench_circle, BENCH_CIRCLE_RADIUS,
+				circle_pixels * 3, circle_pixels},
+	};
+	u32 i;
+
+	if (iterations == 0)
+		iterations = RENDERER_BENCH_DEFAULT_ITERATIONS;
+
+	//the back buffer and the one after it, neither is being scanned out
+	bench_frame = renderer_get_frame_buffer(index);
+	bench_other = renderer_get_frame_buffer(index + 1 < DISPLAY_NUM_FRAMES ? index + 1 : 1);
+	dma_initialize();
+
+	xil_printf("Renderer benchmark, %d passes per case\n\r", iterations);
+	xil_printf("case                  bytes  mean_us  best_us    MB/s  ns/px\n\r");
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+		bench_run_case(&cases[i], iterations);
+}
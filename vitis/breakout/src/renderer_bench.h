@@ -0,0 +1,21 @@
+#ifndef RENDERER_BENCH_H
+#define RENDERER_BENCH_H
+
+#include "xil_types.h"
+
+/*
+ * Standard timings of the render paths: pixel and grey row drawing, the
+ * full-frame clear, cache flushes of several sizes, memcpy against a PL330
+ * DMA copy, and rect and circle fills. Every case runs one untimed warm-up
+ * pass and then the given number of timed passes; the report gives the mean
+ * and best pass, MB/s and ns per pixel from the mean.
+ *
+ * Draws into the back buffer, so call it after renderer_initialize and
+ * before the game takes over the frame buffers.
+ */
+
+#define RENDERER_BENCH_DEFAULT_ITERATIONS 20
+
+void renderer_bench_run(u32 iterations);
+
+#endif //RENDERER_BENCH_H
@@ -0,0 +1,198 @@
+#include "sampler.h"
+
+#include <string.h>
+#include "xparameters.h"
+#include "xscutimer.h"
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "uart_io.h"
+#include "interrupts.h"
+
+#define SAMPLER_MAGIC   "BRKS"
+#define SAMPLER_VERSION 1
+//most buckets sampler_report_top prints
+#define SAMPLER_REPORT_MAX 32
+//the OCM buckets follow the .text ones
+#define SAMPLER_ALL_BUCKETS (SAMPLER_MAX_BUCKETS + SAMPLER_OCM_BUCKETS)
+
+//the private timer runs at half the CPU clock
+#define SAMPLER_TIMER_HZ (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2)
+
+//linker script symbols
+extern char __text_start[];
+extern char __text_end[];
+extern char __ocm_text_start[];
+extern char __ocm_text_end[];
+//top of the IRQ mode stack, see lscript.ld
+extern u32 __irq_stack[];
+
+static XScuTimer sampler_timer;
+static int sampler_timer_ready;
+static int sampler_on;
+static u32 sampler_buckets[SAMPLER_ALL_BUCKETS];
+static u32 sampler_shift;
+static u32 sampler_samples;
+static u32 sampler_outside; //samples outside .text and .ocm_text
+static u32 sampler_hz;
+
+static u32 sampler_bucket_address(u32 bucket){
+	if (bucket >= SAMPLER_MAX_BUCKETS)
+		return (u32)__ocm_text_start + (bucket - SAMPLER_MAX_BUCKETS) * SAMPLER_MIN_BUCKET_BYTES;
+	return (u32)__text_start + (bucket << sampler_shift);
+}
+
+static void sampler_interrupt(void *ref){
+	u32 pc;
+	u32 offset;
+
+	XScuTimer_ClearInterruptStatus(&sampler_timer);
+
+	/*
+	 * The IRQ vector pushes {r0-r3, r12, lr} onto the empty IRQ stack first,
+	 * so the return address is the top word and the interrupted PC is 4 before it
+	 */
+	pc = __irq_stack[-1] - 4;
+
+	sampler_samples++;
+	offset = pc - (u32)__text_start;
+	if (pc >= (u32)__text_start && pc < (u32)__text_end && (offset >> sampler_shift) < SAMPLER_MAX_BUCKETS)
+		sampler_buckets[offset >> sampler_shift]++;
+	else if (pc >= (u32)__ocm_text_start && pc < (u32)__ocm_text_end
+			&& (pc - (u32)__ocm_text_start) / SAMPLER_MIN_BUCKET_BYTES < SAMPLER_OCM_BUCKETS)
+		sampler_buckets[SAMPLER_MAX_BUCKETS + (pc - (u32)__ocm_text_start) / SAMPLER_MIN_BUCKET_BYTES]++;
+	else
+		sampler_outside++;
+}
+
+void sampler_clear(){
+	memset(sampler_buckets, 0, sizeof(sampler_buckets));
+	sampler_samples = 0;
+	sampler_outside = 0;
+}
+
+int sampler_start(u32 hz){
+	XScuTimer_Config *config;
+	u32 text_size = (u32)__text_end - (u32)__text_start;
+	int status;
+
+	if (hz == 0)
+		hz = SAMPLER_DEFAULT_HZ;
+
+	//smallest power of two bucket that covers .text
+	sampler_shift = 0;
+	while ((1U << sampler_shift) < SAMPLER_MIN_BUCKET_BYTES)
+		sampler_shift++;
+	while ((text_size >> sampler_shift) >= SAMPLER_MAX_BUCKETS)
+		sampler_shift++;
+	sampler_clear();
+
+	if (!sampler_timer_ready){
+		config = XScuTimer_LookupConfig(XPAR_XSCUTIMER_0_DEVICE_ID);
+		if (config == NULL)
+			return XST_FAILURE;
+		status = XScuTimer_CfgInitialize(&sampler_timer, config, config->BaseAddr);
+		if (status != XST_SUCCESS){
+			xil_printf("sampler: timer init failed %d\n\r", status);
+			return XST_FAILURE;
+		}
+		sampler_timer_ready = TRUE;
+	}
+
+	//the frame clock uses the same timer while the sampler is off, so take the interrupt back every time
+	status = interrupts_connect(XPAR_SCUTIMER_INTR, sampler_interrupt, NULL, INTERRUPTS_PRIORITY_LOW);
+	if (status != XST_SUCCESS)
+		return XST_FAILURE;
+
+	sampler_hz = hz;
+	XScuTimer_Stop(&sampler_timer);
+	XScuTimer_LoadTimer(&sampler_timer, SAMPLER_TIMER_HZ / hz - 1);
+	XScuTimer_EnableAutoReload(&sampler_timer);
+	XScuTimer_ClearInterruptStatus(&sampler_timer);
+	XScuTimer_EnableInterrupt(&sampler_timer);
+	XScuTimer_Start(&sampler_timer);
+	sampler_on = TRUE;
+
+	xil_printf("sampler: %d Hz, .text %d bytes in %d byte buckets\n\r",
+			hz, text_size, 1 << sampler_shift);
+	return XST_SUCCESS;
+}
+
+void sampler_stop(){
+	if (!sampler_timer_ready)
+		return;
+
+	XScuTimer_DisableInterrupt(&sampler_timer);
+	XScuTimer_Stop(&sampler_timer);
+	sampler_on = FALSE;
+}
+
+int sampler_running(){
+	return sampler_on;
+}
+
+u32 sampler_total(){
+	return sampler_samples;
+}
+
+void sampler_report_top(int count){
+	u32 taken[SAMPLER_REPORT_MAX];
+	u32 best;
+	u32 i;
+	int n;
+	int t;
+	int used;
+
+	xil_printf("samples %d (%d outside .text and .ocm_text)\n\r", sampler_samples, sampler_outside);
+	if (sampler_samples == 0)
+		return;
+	if (count > SAMPLER_REPORT_MAX)
+		count = SAMPLER_REPORT_MAX;
+
+	//selection of the largest buckets, the report is not time critical
+	for (n = 0; n < count; n++){
+		best = SAMPLER_ALL_BUCKETS;
+		for (i = 0; i < SAMPLER_ALL_BUCKETS; i++){
+			if (sampler_buckets[i] == 0)
+				continue;
+			used = FALSE;
+			for (t = 0; t < n; t++)
+				used |= taken[t] == i;
+			if (!used && (best == SAMPLER_ALL_BUCKETS || sampler_buckets[i] > sampler_buckets[best]))
+				best = i;
+		}
+		if (best == SAMPLER_ALL_BUCKETS)
+			break;
+		taken[n] = best;
+		xil_printf("  0x%08x %7d %3d%%\n\r",
+				sampler_bucket_address(best),
+				sampler_buckets[best],
+				sampler_buckets[best] * 100 / sampler_samples);
+	}
+}
+
+void sampler_dump_uart(){
+	const char *magic = SAMPLER_MAGIC;
+	u32 used = 0;
+	u32 i;
+
+	for (i = 0; i < SAMPLER_ALL_BUCKETS; i++)
+		used += sampler_buckets[i] != 0;
+
+	for (i = 0; i < 4; i++)
+		outbyte(magic[i]);
+	uart_write_u32(SAMPLER_VERSION);
+	uart_write_u32(sampler_hz);
+	uart_write_u32((u32)__text_start);
+	uart_write_u32(1 << sampler_shift);
+	uart_write_u32(sampler_samples);
+	uart_write_u32(sampler_outside);
+
+	//only the buckets that were hit, as address and count pairs
+	uart_write_u32(used);
+	for (i = 0; i < SAMPLER_ALL_BUCKETS; i++){
+		if (sampler_buckets[i] == 0)
+			continue;
+		uart_write_u32(sampler_bucket_address(i));
+		uart_write_u32(sampler_buckets[i]);
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "xil_types.h"
+
+/*
+ * Statistical PC sampler: the SCU private timer interrupts at a fixed rate
+ * and the interrupted PC is counted into a histogram over the .text section.
+ * sampler_dump_uart() sends the histogram over the stdout UART and
+ * tools/symbolize_samples.py maps it to functions with the ELF's symbols.
+ *
+ * The buckets are SAMPLER_MIN_BUCKET_BYTES wide, or wider when .text would
+ * need more than SAMPLER_MAX_BUCKETS of them. Code placed in OCM (see
+ * placement.h) has its own SAMPLER_MIN_BUCKET_BYTES buckets.
+ */
+
+#define SAMPLER_MAX_BUCKETS      16384
+#define SAMPLER_MIN_BUCKET_BYTES 16
+#define SAMPLER_OCM_BUCKETS      4096
+#define SAMPLER_DEFAULT_HZ       10000
+
+int sampler_start(u32 hz);
+void sampler_stop();
+//TRUE while the sampler owns the private timer
+int sampler_running();
+void sampler_clear();
+
+u32 sampler_total();
+//prints the count buckets with the most samples, as raw addresses
+void sampler_report_top(int count);
+void sampler_dump_uart();
+
+#endif //SAMPLER_H
@@ -0,0 +1,162 @@
+#include "scheduler.h"
+
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "frameclock.h"
+#include "profiler.h"
+
+#define SCHEDULER_TO_US(counts) ((u32)(((counts) * PROFILER_US_PER_COUNT_Q32) >> 32))
+
+static int scheduler_ready;
+static scheduler_task_s *scheduler_tasks[SCHEDULER_MAX_TASKS];
+static int scheduler_task_count;
+//round robin position in scheduler_tasks for each priority
+static int scheduler_next[SCHEDULER_PRIORITIES];
+
+int scheduler_add(scheduler_task_s *task, const char *name, scheduler_task_fn run, void *ref,
+		scheduler_priority_e priority, u32 slice_us){
+	if (scheduler_task_count == SCHEDULER_MAX_TASKS || priority >= SCHEDULER_PRIORITIES)
+		return XST_FAILURE;
+
+	task->name = name;
+	task->run = run;
+	task->ref = ref;
+	task->priority = priority;
+	task->slice_us = slice_us;
+	scheduler_tasks[scheduler_task_count++] = task;
+
+	task->runs = 0;
+	task->polls = 0;
+	task->total_counts = 0;
+	task->max_us = 0;
+	task->overruns = 0;
+	task->deferred = 0;
+	return XST_SUCCESS;
+}
+
+void scheduler_remove(scheduler_task_s *task){
+	int i;
+
+	for (i = 0; i < scheduler_task_count; i++){
+		if (scheduler_tasks[i] == task){
+			scheduler_tasks[i] = scheduler_tasks[--scheduler_task_count];
+			return;
+		}
+	}
+}
+
+static int scheduler_idle(void *ref, u32 budget_us){
+	return scheduler_run(budget_us) > 0;
+}
+
+int scheduler_initialize(){
+	if (scheduler_ready)
+		return XST_SUCCESS;
+	if (frameclock_add_idle_task(scheduler_idle, NULL) != XST_SUCCESS)
+		return XST_FAILURE;
+	scheduler_ready = TRUE;
+	return XST_SUCCESS;
+}
+
+/*
+ * Next task of the highest priority that has one ready, in round robin order.
+ * done has a bit per task already finished for this run. A task whose slice
+ * does not fit is skipped so a smaller one can still use the time, and
+ * counted once per run in deferred.
+ */
+static int scheduler_pick(u32 done, u32 *deferred, u32 left_us){
+	scheduler_task_s *task;
+	int priority, i, index;
+
+	for (priority = 0; priority < SCHEDULER_PRIORITIES; priority++){
+		for (i = 0; i < scheduler_task_count; i++){
+			index = (scheduler_next[priority] + i) % scheduler_task_count;
+			task = scheduler_tasks[index];
+			if (task->priority != priority || (done & (1 << index)))
+				continue;
+			if (task->slice_us > left_us){
+				if (!(*deferred & (1 << index))){
+					*deferred |= 1 << index;
+					task->deferred++;
+				}
+				continue;
+			}
+			scheduler_next[priority] = (index + 1) % scheduler_task_count;
+			return index;
+		}
+	}
+	return -1;
+}
+
+u32 scheduler_run(u32 budget_us){
+	scheduler_task_s *task;
+	XTime run_start, start, end;
+	u32 done = 0;
+	u32 deferred = 0;
+	u32 used_us = 0;
+	u32 runs = 0;
+	u32 us;
+	int index;
+
+	XTime_GetTime(&run_start);
+	end = run_start;
+	while ((index = scheduler_pick(done, &deferred, budget_us - used_us)) >= 0){
+		task = scheduler_tasks[index];
+
+		start = end;
+		if (!task->run(task->ref)){
+			task->polls++;
+			done |= 1 << index;
+		} else {
+			task->runs++;
+			runs++;
+		}
+		XTime_GetTime(&end);
+
+		us = SCHEDULER_TO_US(end - start);
+		task->total_counts += end - start;
+		if (us > task->max_us)
+			task->max_us = us;
+		if (us > task->slice_us)
+			task->overruns++;
+
+		used_us = SCHEDULER_TO_US(end - run_start);
+		if (used_us >= budget_us)
+			break;
+	}
+	return runs;
+}
+
+void scheduler_reset_accounts(){
+	scheduler_task_s *task;
+	int i;
+
+	for (i = 0; i < scheduler_task_count; i++){
+		task = scheduler_tasks[i];
+		task->runs = 0;
+		task->polls = 0;
+		task->total_counts = 0;
+		task->max_us = 0;
+		task->overruns = 0;
+		task->deferred = 0;
+	}
+}
+
+void scheduler_report(){
+	scheduler_task_s *task;
+	int i;
+
+	if (scheduler_task_count == 0)
+		return;
+
+	xil_printf("%-16s %4s %8s %8s %10s %8s %8s %8s %8s\n\r",
+			"task", "prio", "slice_us", "runs", "total_us", "mean_us", "max_us", "overrun", "deferred");
+	for (i = 0; i < scheduler_task_count; i++){
+		task = scheduler_tasks[i];
+		xil_printf("%-16s %4d %8d %8d %10d %8d %8d %8d %8d\n\r",
+				task->name, task->priority, task->slice_us, task->runs,
+				SCHEDULER_TO_US(task->total_counts),
+				task->runs + task->polls ? SCHEDULER_TO_US(task->total_counts) / (task->runs + task->polls) : 0,
+				task->max_us, task->overruns, task->deferred);
+	}
+}
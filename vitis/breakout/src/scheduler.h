@@ -0,0 +1,67 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "xil_types.h"
+#include "xtime_l.h"
+
+/*
+ * Cooperative run-to-completion scheduler for background work. A task does
+ * one slice of its work per call and returns; slices are never preempted.
+ * scheduler_run() is handed the time left in the frame and keeps picking the
+ * highest priority task whose declared slice still fits, round robin within a
+ * priority, so background work never pushes the frame past its deadline as
+ * long as the tasks keep to their slice. It runs as a frame clock idle task
+ * (see frameclock.h) once scheduler_initialize() has been called.
+ *
+ * Every task keeps an account of its runs and execution time, and of slices
+ * that took longer than declared.
+ */
+
+#define SCHEDULER_MAX_TASKS 8
+
+typedef enum {
+	SCHEDULER_PRIORITY_HIGH = 0,
+	SCHEDULER_PRIORITY_NORMAL,
+	SCHEDULER_PRIORITY_LOW,
+	SCHEDULER_PRIORITIES
+} scheduler_priority_e;
+
+//does at most slice_us of work, returns FALSE when there was nothing to do
+typedef int (*scheduler_task_fn)(void *ref);
+
+typedef struct {
+	const char *name;
+	scheduler_task_fn run;
+	void *ref;
+	scheduler_priority_e priority;
+	u32 slice_us;      //longest a slice is expected to take
+
+	//account since the last scheduler_reset_accounts()
+	u32 runs;          //slices that did work
+	u32 polls;         //calls that found nothing to do
+	u64 total_counts;  //XTime counts spent in the task
+	u32 max_us;
+	u32 overruns;      //slices longer than slice_us
+	u32 deferred;      //times it had to wait because its slice did not fit the budget
+} scheduler_task_s;
+
+//the task struct must stay valid while the task is registered
+int scheduler_add(scheduler_task_s *task, const char *name, scheduler_task_fn run, void *ref,
+		scheduler_priority_e priority, u32 slice_us);
+void scheduler_remove(scheduler_task_s *task);
+
+//registers the scheduler as a frame clock idle task
+int scheduler_initialize();
+
+/*
+ * Runs task slices until none is ready or the next one's slice does not fit in
+ * what is left of budget_us. A task that found nothing to do is not called
+ * again in the same run. Returns the number of slices that did work, so 0
+ * means every task only polled.
+ */
+u32 scheduler_run(u32 budget_us);
+
+void scheduler_reset_accounts();
+void scheduler_report();
+
+#endif //SCHEDULER_H
@@ -0,0 +1,185 @@
+#include "snapshot.h"
+
+#include <string.h>
+#include "xil_printf.h"
+#include "uart_io.h"
+#include "xstatus.h"
+
+#define SNAPSHOT_MAGIC "BRKG"
+
+#ifdef BREAKOUT_FIXED_POINT
+#define SNAPSHOT_FLAGS SNAPSHOT_FLAG_FIXED_POINT
+#else
+#define SNAPSHOT_FLAGS 0
+#endif
+
+typedef char snapshot_bricks_fit[(BRICK_ROWS * BRICK_COLS <= 64) ? 1 : -1];
+
+static snapshot_s snapshot_ring[SNAPSHOT_RING_SIZE];
+static u32 ring_next;  //total images pushed, the newest is at ring_next - 1
+static u32 ring_count;
+
+//scalar_t is a float or a fixed_t, either way 32 bits copied as they are
+static u32 scalar_bits(scalar_t value){
+	u32 bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static scalar_t scalar_from_bits(u32 bits){
+	scalar_t value;
+
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+void snapshot_capture(const GameState *game, u32 frame, snapshot_s *image){
+	int i;
+
+	image->version = SNAPSHOT_VERSION;
+	image->flags = SNAPSHOT_FLAGS;
+	image->size = sizeof(snapshot_s);
+	image->frame = frame;
+
+	image->ball_x = scalar_bits(game->ball.x);
+	image->ball_y = scalar_bits(game->ball.y);
+	image->ball_vx = scalar_bits(game->ball.vx);
+	image->ball_vy = scalar_bits(game->ball.vy);
+	image->paddle_x = scalar_bits(game->paddle.x);
+	image->paddle_vx = scalar_bits(game->paddle.vx);
+
+	image->bricks_alive = 0;
+	for (i = 0; i < BRICK_ROWS * BRICK_COLS; i++)
+		if (game->bricks[i].alive)
+			image->bricks_alive |= (u64)1 << i;
+
+	image->score = game->score;
+	image->lives = (u8)game->lives;
+	image->bricks_remaining = (u8)game->bricks_remaining;
+	image->game_running = (u8)game->game_running;
+	image->ball_launched = (u8)game->ball_launched;
+}
+
+int snapshot_restore(const snapshot_s *image, GameState *game){
+	int i;
+
+	if (image->version != SNAPSHOT_VERSION || image->size != sizeof(snapshot_s)){
+		xil_printf("snapshot: version %d size %d, expected %d size %d\n\r",
+				image->version, image->size, SNAPSHOT_VERSION, sizeof(snapshot_s));
+		return XST_FAILURE;
+	}
+	if (image->flags != SNAPSHOT_FLAGS){
+		xil_printf("snapshot: taken with the other scalar type (flags %x)\n\r", image->flags);
+		return XST_FAILURE;
+	}
+
+	//brick positions and the paddle height
+	init_game(game);
+
+	game->ball.x = scalar_from_bits(image->ball_x);
+	game->ball.y = scalar_from_bits(image->ball_y);
+	game->ball.vx = scalar_from_bits(image->ball_vx);
+	game->ball.vy = scalar_from_bits(image->ball_vy);
+	game->paddle.x = scalar_from_bits(image->paddle_x);
+	game->paddle.vx = scalar_from_bits(image->paddle_vx);
+
+	for (i = 0; i < BRICK_ROWS * BRICK_COLS; i++)
+		game->bricks[i].alive = (image->bricks_alive >> i) & 1;
+
+	game->score = image->score;
+	game->lives = image->lives;
+	game->bricks_remaining = image->bricks_remaining;
+	game->game_running = image->game_running;
+	game->ball_launched = image->ball_launched;
+	return XST_SUCCESS;
+}
+
+void snapshot_ring_push(const GameState *game, u32 frame){
+	snapshot_capture(game, frame, &snapshot_ring[ring_next & (SNAPSHOT_RING_SIZE - 1)]);
+	ring_next++;
+	if (ring_count < SNAPSHOT_RING_SIZE)
+		ring_count++;
+}
+
+void snapshot_ring_clear(){
+	ring_next = 0;
+	ring_count = 0;
+}
+
+u32 snapshot_ring_count(){
+	return ring_count;
+}
+
+const snapshot_s *snapshot_ring_get(u32 frames_ago){
+	if (frames_ago >= ring_count)
+		return NULL;
+	return &snapshot_ring[(ring_next - 1 - frames_ago) & (SNAPSHOT_RING_SIZE - 1)];
+}
+
+const snapshot_s *snapshot_ring_find(u32 frame){
+	const snapshot_s *newest = snapshot_ring_get(0);
+
+	if (!newest || frame > newest->frame)
+		return NULL;
+	//one image per frame, so the frames in the ring are consecutive
+	return snapshot_ring_get(newest->frame - frame);
+}
+
+int snapshot_ring_rewind(u32 frames_ago, GameState *game){
+	const snapshot_s *image = snapshot_ring_get(frames_ago);
+
+	if (!image)
+		return XST_FAILURE;
+	if (snapshot_restore(image, game) != XST_SUCCESS)
+		return XST_FAILURE;
+
+	ring_next -= frames_ago;
+	ring_count -= frames_ago;
+	return XST_SUCCESS;
+}
+
+void snapshot_ring_dump_uart(){
+	const char *magic = SNAPSHOT_MAGIC;
+	const u8 *bytes;
+	u32 i, j;
+
+	for (i = 0; i < 4; i++)
+		outbyte(magic[i]);
+	uart_write_u32(ring_count);
+	//oldest first
+	for (i = ring_count; i > 0; i--){
+		bytes = (const u8 *)snapshot_ring_get(i - 1);
+		for (j = 0; j < sizeof(snapshot_s); j++)
+			outbyte(bytes[j]);
+	}
+}
+
+int snapshot_load_uart(snapshot_s *image){
+	const char *magic = SNAPSHOT_MAGIC;
+	u8 *bytes = (u8 *)image;
+	u32 count;
+	u32 i, j;
+
+	for (i = 0; i < 4; i++){
+		if (inbyte() != magic[i]){
+			xil_printf("Snapshot load failed: bad magic\n\r");
+			return XST_FAILURE;
+		}
+	}
+
+	count = uart_read_u32();
+	if (count == 0){
+		xil_printf("Snapshot load failed: no images\n\r");
+		return XST_FAILURE;
+	}
+	for (i = 0; i < count; i++)
+		for (j = 0; j < sizeof(snapshot_s); j++)
+			bytes[j] = (u8)inbyte();
+
+	if (image->version != SNAPSHOT_VERSION || image->size != sizeof(snapshot_s)){
+		xil_printf("Snapshot load failed: version %d size %d\n\r", image->version, image->size);
+		return XST_FAILURE;
+	}
+	return XST_SUCCESS;
+}
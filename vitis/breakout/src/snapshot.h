@@ -0,0 +1,66 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "xil_types.h"
+#include "breakout_game.h"
+
+/*
+ * Compact, versioned images of the GameState taken at frame boundaries.
+ * The brick positions never change, so an image only keeps which bricks are
+ * alive and restoring rebuilds the rest with init_game(). A ring of the last
+ * SNAPSHOT_RING_SIZE frames lets a glitch be rolled back to and replayed, and
+ * images can be sent over the stdout UART to start a later run from them
+ * (tools/snapshots.py lists a dump and extracts single images).
+ *
+ * UART format: "BRKG" magic, u32 image count, then the images as they are in
+ * memory (little endian, sizeof(snapshot_s) bytes each).
+ */
+
+#define SNAPSHOT_VERSION          1
+//the scalars are Q16.16 fixed_t, otherwise float
+#define SNAPSHOT_FLAG_FIXED_POINT 0x01
+//must be a power of two
+#define SNAPSHOT_RING_SIZE        256
+
+typedef struct {
+	u16 version;
+	u8 flags;
+	u8 size;            //sizeof(snapshot_s)
+	u32 frame;
+
+	//scalar_t bit patterns
+	u32 ball_x;
+	u32 ball_y;
+	u32 ball_vx;
+	u32 ball_vy;
+	u32 paddle_x;
+	u32 paddle_vx;
+
+	u64 bricks_alive;   //bit per brick, row major
+	s32 score;
+	u8 lives;
+	u8 bricks_remaining;
+	u8 game_running;
+	u8 ball_launched;
+} snapshot_s;
+
+void snapshot_capture(const GameState *game, u32 frame, snapshot_s *image);
+//fails if the image is from another version or the other scalar type
+int snapshot_restore(const snapshot_s *image, GameState *game);
+
+//captures the game into the ring, call once per frame after the update
+void snapshot_ring_push(const GameState *game, u32 frame);
+void snapshot_ring_clear();
+u32 snapshot_ring_count();
+//0 is the newest image, NULL if the ring does not go back that far
+const snapshot_s *snapshot_ring_get(u32 frames_ago);
+//NULL if the frame is no longer (or not yet) in the ring
+const snapshot_s *snapshot_ring_find(u32 frame);
+//restores the image frames_ago back and drops the newer ones, so the game can run on from there
+int snapshot_ring_rewind(u32 frames_ago, GameState *game);
+
+void snapshot_ring_dump_uart();
+//blocks until a dump arrives and keeps its newest image
+int snapshot_load_uart(snapshot_s *image);
+
+#endif //SNAPSHOT_H
@@ -0,0 +1,108 @@
+#include "trace.h"
+
+#include <string.h>
+#include "xil_printf.h"
+#include "uart_io.h"
+
+#define TRACE_MAGIC "BRKT"
+#define TRACE_VERSION 1
+
+trace_event_s trace_events[TRACE_MAX_EVENTS];
+u32 trace_head;
+int trace_enabled;
+
+static const char *trace_names[TRACE_MAX_NAMES];
+static u32 trace_name_count;
+
+u16 trace_register(const char *name){
+	u32 i;
+
+	for (i = 0; i < trace_name_count; i++){
+		if (strcmp(trace_names[i], name) == 0)
+			return (u16)i;
+	}
+
+	if (trace_name_count == TRACE_MAX_NAMES)
+		return TRACE_INVALID_ID;
+
+	trace_names[trace_name_count] = name;
+	return (u16)trace_name_count++;
+}
+
+void trace_start(){
+	trace_enabled = TRUE;
+}
+
+void trace_stop(){
+	trace_enabled = FALSE;
+}
+
+void trace_clear(){
+	trace_head = 0;
+}
+
+void trace_begin(u16 name_id){
+	XTime now;
+
+	XTime_GetTime(&now);
+	trace_record(TRACE_BEGIN, name_id, now, 0);
+}
+
+void trace_end(u16 name_id){
+	XTime now;
+
+	XTime_GetTime(&now);
+	trace_record(TRACE_END, name_id, now, 0);
+}
+
+void trace_instant(u16 name_id, u32 arg){
+	XTime now;
+
+	XTime_GetTime(&now);
+	trace_record(TRACE_INSTANT, name_id, now, arg);
+}
+
+void trace_dump_uart(){
+	const char *magic = TRACE_MAGIC;
+	int was_enabled = trace_enabled;
+	trace_event_s *event;
+	u32 count;
+	u32 first;
+	u32 i;
+	u32 len;
+
+	//stop recording so the ring does not move under the dump
+	trace_enabled = FALSE;
+
+	count = trace_head < TRACE_MAX_EVENTS ? trace_head : TRACE_MAX_EVENTS;
+	first = trace_head - count;
+
+	for (i = 0; i < 4; i++)
+		outbyte(magic[i]);
+	uart_write_u32(TRACE_VERSION);
+	uart_write_u32(COUNTS_PER_SECOND);
+
+	uart_write_u32(trace_name_count);
+	for (i = 0; i < trace_name_count; i++){
+		len = strlen(trace_names[i]);
+		if (len > 255)
+			len = 255;
+		outbyte((char)len);
+		for (u32 c = 0; c < len; c++)
+			outbyte(trace_names[i][c]);
+	}
+
+	uart_write_u32(count);
+	for (i = 0; i < count; i++){
+		event = &trace_events[(first + i) & (TRACE_MAX_EVENTS - 1)];
+		uart_write_u32((u32)(event->timestamp & 0xFFFFFFFF));
+		uart_write_u32((u32)(event->timestamp >> 32));
+		outbyte(event->name_id & 0xFF);
+		outbyte(event->name_id >> 8);
+		outbyte(event->type);
+		outbyte(0);
+		uart_write_u32(event->arg);
+	}
+
+	trace_enabled = was_enabled;
+}
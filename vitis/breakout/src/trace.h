@@ -0,0 +1,73 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "xil_types.h"
+#include "xtime_l.h"
+
+/*
+ * Event tracer: begin/end/instant events with global timer timestamps are
+ * written into a preallocated ring buffer (the oldest events are overwritten)
+ * and dumped as a binary stream over the stdout UART on demand.
+ * tools/trace_to_chrome.py converts a dump to Chrome trace JSON for Perfetto.
+ *
+ * Profiler zones emit begin/end events automatically while tracing is enabled.
+ */
+
+//must be a power of two, each event is 16 bytes
+#define TRACE_MAX_EVENTS 16384
+#define TRACE_MAX_NAMES  64
+
+#define TRACE_INVALID_ID 0xFFFF
+
+typedef enum {
+	TRACE_BEGIN   = 0,
+	TRACE_END     = 1,
+	TRACE_INSTANT = 2
+} trace_type_e;
+
+typedef struct {
+	XTime timestamp;
+	u16 name_id;
+	u8 type;
+	u8 reserved;
+	u32 arg;
+} trace_event_s;
+
+extern trace_event_s trace_events[TRACE_MAX_EVENTS];
+extern u32 trace_head; //total events written, the ring index is trace_head % TRACE_MAX_EVENTS
+extern int trace_enabled;
+
+//returns the id for name, registering it if needed (TRACE_INVALID_ID when the table is full)
+u16 trace_register(const char *name);
+
+void trace_start();
+void trace_stop();
+void trace_clear();
+
+//hot path, kept inline so an event costs a few stores
+static inline void trace_record(trace_type_e type, u16 name_id, XTime timestamp, u32 arg){
+	trace_event_s *event;
+
+	if (!trace_enabled || name_id == TRACE_INVALID_ID)
+		return;
+
+	event = &trace_events[trace_head++ & (TRACE_MAX_EVENTS - 1)];
+	event->timestamp = timestamp;
+	event->name_id = name_id;
+	event->type = (u8)type;
+	event->arg = arg;
+}
+
+void trace_begin(u16 name_id);
+void trace_end(u16 name_id);
+void trace_instant(u16 name_id, u32 arg);
+
+/*
+ * Binary dump, all values little endian:
+ *   "BRKT", u32 version, u32 counts per second,
+ *   u32 name count, per name: u8 length + characters,
+ *   u32 event count, per event: u64 timestamp, u16 name id, u8 type, u8 0, u32 arg
+ */
+void trace_dump_uart();
+
+#endif //TRACE_H
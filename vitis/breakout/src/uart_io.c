@@ -0,0 +1,20 @@
+#include "uart_io.h"
+
+#include "xil_printf.h"
+
+void uart_write_u32(u32 value){
+	outbyte(value & 0xFF);
+	outbyte((value >> 8) & 0xFF);
+	outbyte((value >> 16) & 0xFF);
+	outbyte((value >> 24) & 0xFF);
+}
+
+u32 uart_read_u32(){
+	u32 value;
+
+	value  = (u32)(u8)inbyte();
+	value |= (u32)(u8)inbyte() << 8;
+	value |= (u32)(u8)inbyte() << 16;
+	value |= (u32)(u8)inbyte() << 24;
+	return value;
+}
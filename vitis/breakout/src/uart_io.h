@@ -0,0 +1,15 @@
+#ifndef UART_IO_H
+#define UART_IO_H
+
+#include "xil_types.h"
+
+/*
+ * Little endian word I/O on the stdout UART, shared by the binary dump and
+ * load formats.
+ * Both block until every byte has been sent or received.
+ */
+
+void uart_write_u32(u32 value);
+u32 uart_read_u32();
+
+#endif //UART_IO_H